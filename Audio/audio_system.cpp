@@ -0,0 +1,279 @@
+#include "audio_system.h" // Include the corresponding header file
+
+#include <iostream>
+#include <algorithm>
+
+#include "../Metrics/metrics.h"
+#include "../Profiler/alloc_tracker.h"
+#include "../Profiler/memory_report.h"
+#include "../Profiler/profiler.h"
+
+// Volume boost applied for every extra trigger merged into one play, and its upper limit
+static const float COALESCE_GAIN_STEP = 0.25f;
+static const float COALESCE_GAIN_MAX = 2.0f;
+
+// The device asks for the next period about one period after the previous one.
+// A gap this many times longer means its buffer ran dry in between.
+static const double XRUN_GAP_FACTOR = 2.0;
+
+// Constructor: Nothing is created here, init() does the actual miniaudio setup.
+AudioSystem::AudioSystem()
+    : m_deviceReady(false), m_engineReady(false),
+    m_offline(false), m_encoderReady(false), m_offlineChannels(0), m_offlineFrameDebt(0.0), m_offlineBuffer(nullptr),
+    m_musicLoaded(false), m_musicReady(false),
+    m_hasLastCallback(false), m_lastBudgetSeconds(0.0), m_trackedBytes(0.0)
+{
+    for (int i = 0; i < NUM_SOUNDS; ++i) {
+        m_soundLoaded[i] = false;
+        m_baseVolume[i] = 1.0f;
+        m_pendingTriggers[i] = 0;
+    }
+}
+
+// Destructor: Stops the audio thread first so the callback can't touch sounds being destroyed.
+AudioSystem::~AudioSystem() {
+    if (m_deviceReady) {
+        ma_device_stop(&m_device);
+    }
+    for (int i = 0; i < NUM_SOUNDS; ++i) {
+        if (m_soundLoaded[i]) {
+            ma_sound_uninit(&m_sounds[i]);
+        }
+    }
+    if (m_musicLoaded) {
+        ma_sound_uninit(&m_musicSound); // m_music itself is closed by its own destructor afterwards
+    }
+    if (m_engineReady) {
+        ma_engine_uninit(&m_engine);
+        std::cout << "Audio engine uninitialized." << std::endl;
+    }
+    if (m_deviceReady) {
+        ma_device_uninit(&m_device);
+    }
+    if (m_encoderReady) {
+        ma_encoder_uninit(&m_encoder); // Finalizes the WAV header
+    }
+    delete[] m_offlineBuffer;
+    memoryAdd(MEMORY_AUDIO, -m_trackedBytes, 0.0);
+}
+
+// Size of a sound once the resource manager has decoded it: 32-bit float at the engine's rate, in the file's channels.
+// Only the header is read, the sound itself may still be decoding asynchronously.
+static double decodedSoundBytes(const char* path, ma_uint32 sampleRate) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, sampleRate);
+    ma_decoder decoder;
+    if (ma_decoder_init_file(path, &config, &decoder) != MA_SUCCESS) return 0.0;
+    ma_uint64 frames = 0;
+    ma_decoder_get_length_in_pcm_frames(&decoder, &frames);
+    double bytes = static_cast<double>(frames) * decoder.outputChannels * sizeof(float);
+    ma_decoder_uninit(&decoder);
+    return bytes;
+}
+
+void AudioSystem::trackMemory(double bytes) {
+    m_trackedBytes += bytes;
+    memoryAdd(MEMORY_AUDIO, bytes, 0.0);
+}
+
+// Creates our own playback device (so we control its data callback) and an engine mixing into it.
+bool AudioSystem::init() {
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = ma_format_f32; // The engine always mixes in 32-bit float
+    deviceConfig.playback.channels = 0;           // Use the device's native channel count
+    deviceConfig.sampleRate = 0;                  // Use the device's native sample rate
+    deviceConfig.dataCallback = dataCallback;
+    deviceConfig.pUserData = this;
+
+    if (ma_device_init(NULL, &deviceConfig, &m_device) != MA_SUCCESS) {
+        std::cerr << "Failed to initialize audio device." << std::endl;
+        return false;
+    }
+    m_deviceReady = true;
+
+    ma_engine_config engineConfig = ma_engine_config_init();
+    engineConfig.pDevice = &m_device;   // The engine mixes into our device
+    engineConfig.noAutoStart = MA_TRUE; // Start only once everything below is ready for the callback
+
+    if (ma_engine_init(&engineConfig, &m_engine) != MA_SUCCESS) {
+        std::cerr << "Failed to initialize audio engine." << std::endl;
+        return false;
+    }
+    m_engineReady = true;
+
+    if (ma_engine_start(&m_engine) != MA_SUCCESS) {
+        std::cerr << "Failed to start audio engine." << std::endl;
+        return false;
+    }
+    std::cout << "Audio engine initialized." << std::endl;
+    return true;
+}
+
+// Creates an engine without any device. Nothing plays on its own: advance() mixes the audio
+// for each simulation tick and writes it to a WAV file, so the output is sample-accurate and
+// identical between runs regardless of frame rate or sound hardware.
+bool AudioSystem::initOffline(const char* wavPath, ma_uint32 sampleRate, ma_uint32 channels) {
+    m_offline = true;
+
+    ma_engine_config engineConfig = ma_engine_config_init();
+    engineConfig.noDevice = MA_TRUE;
+    engineConfig.channels = channels;     // Must be set explicitly when there's no device
+    engineConfig.sampleRate = sampleRate;
+
+    if (ma_engine_init(&engineConfig, &m_engine) != MA_SUCCESS) {
+        std::cerr << "Failed to initialize offline audio engine." << std::endl;
+        return false;
+    }
+    m_engineReady = true;
+
+    ma_encoder_config encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, channels, sampleRate);
+    if (ma_encoder_init_file(wavPath, &encoderConfig, &m_encoder) != MA_SUCCESS) {
+        std::cerr << "Failed to open audio output file: " << wavPath << std::endl;
+        return false;
+    }
+    m_encoderReady = true;
+
+    m_offlineChannels = channels;
+    m_offlineBuffer = new float[OFFLINE_CHUNK_FRAMES * channels];
+    trackMemory(OFFLINE_CHUNK_FRAMES * channels * sizeof(float));
+    std::cout << "Offline audio rendering to " << wavPath << " (" << sampleRate << " Hz, " << channels << " channels)" << std::endl;
+    return true;
+}
+
+// Loads a sound effect fully decoded in memory and remembers its base volume.
+bool AudioSystem::loadSound(SoundID id, const char* path, float volume) {
+    if (!m_engineReady) return false;
+
+    // Offline runs load synchronously so the very first tick already hears the sound
+    ma_uint32 flags = MA_SOUND_FLAG_DECODE;
+    if (!m_offline) flags |= MA_SOUND_FLAG_ASYNC;
+
+    ma_result result = ma_sound_init_from_file(&m_engine, path, flags, NULL, NULL, &m_sounds[id]);
+    if (result != MA_SUCCESS) {
+        std::cerr << "Failed to load sound " << path << ": " << result << std::endl;
+        return false;
+    }
+    ma_sound_set_volume(&m_sounds[id], volume);
+    m_baseVolume[id] = volume;
+    m_soundLoaded[id] = true;
+    trackMemory(decodedSoundBytes(path, ma_engine_get_sample_rate(&m_engine)));
+    std::cout << "Sound loaded: " << path << std::endl;
+    return true;
+}
+
+// Opens the music file as a stream and starts it looping. Unlike the effects, it is never
+// fully decoded: the audio thread decodes it chunk by chunk into a small ring buffer.
+bool AudioSystem::playMusic(const char* path, float volume) {
+    if (!m_engineReady) return false;
+
+    if (!m_music.open(path, ma_engine_get_channels(&m_engine), ma_engine_get_sample_rate(&m_engine))) {
+        return false;
+    }
+
+    if (ma_sound_init_from_data_source(&m_engine, m_music.getDataSource(), 0, NULL, &m_musicSound) != MA_SUCCESS) {
+        std::cerr << "Failed to create music sound: " << path << std::endl;
+        m_music.close();
+        return false;
+    }
+    m_musicLoaded = true;
+    // Only the ring counts, the mapped file is page cache the OS can drop at any time
+    trackMemory(MusicStream::RING_FRAMES * ma_engine_get_channels(&m_engine) * sizeof(float));
+    ma_sound_set_volume(&m_musicSound, volume);
+
+    m_musicReady.store(true, std::memory_order_release); // From now on the audio thread owns the stream
+    ma_sound_start(&m_musicSound);
+    return true;
+}
+
+// Game thread: only counts the request, nothing is sent until flush().
+void AudioSystem::trigger(SoundID id) {
+    m_pendingTriggers[id]++;
+}
+
+// Game thread: sends one command per sound triggered this tick, carrying how many times it was triggered.
+void AudioSystem::flush() {
+    for (int i = 0; i < NUM_SOUNDS; ++i) {
+        if (m_pendingTriggers[i] == 0) continue;
+
+        AudioCommand command;
+        command.sound = static_cast<SoundID>(i);
+        command.count = m_pendingTriggers[i];
+        if (!m_commandQueue.push(command)) {
+            metricAdd(METRIC_AUDIO_DROPPED_COMMANDS, 1);
+        }
+        m_pendingTriggers[i] = 0;
+    }
+}
+
+// Offline mode: the game thread takes the audio thread's role, applies this tick's commands
+// and mixes exactly as many frames as the simulated time covers.
+void AudioSystem::advance(float deltaTime) {
+    if (!m_offline || !m_encoderReady) return;
+
+    processCommands();
+
+    m_offlineFrameDebt += static_cast<double>(deltaTime) * ma_engine_get_sample_rate(&m_engine);
+    ma_uint64 framesToMix = static_cast<ma_uint64>(m_offlineFrameDebt);
+    m_offlineFrameDebt -= static_cast<double>(framesToMix);
+
+    while (framesToMix > 0) {
+        ma_uint64 chunk = std::min<ma_uint64>(framesToMix, OFFLINE_CHUNK_FRAMES);
+        if (m_musicReady.load(std::memory_order_acquire)) m_music.refill();
+        ma_engine_read_pcm_frames(&m_engine, m_offlineBuffer, chunk, NULL);
+        ma_encoder_write_pcm_frames(&m_encoder, m_offlineBuffer, chunk, NULL);
+        framesToMix -= chunk;
+    }
+}
+
+// Audio thread (game thread in offline mode): restarts every requested sound, louder when several triggers were merged.
+void AudioSystem::processCommands() {
+    AudioCommand command;
+    while (m_commandQueue.pop(command)) {
+        if (!m_soundLoaded[command.sound]) continue;
+
+        ma_sound* sound = &m_sounds[command.sound];
+        float gain = std::min(1.0f + COALESCE_GAIN_STEP * (command.count - 1), COALESCE_GAIN_MAX);
+        ma_sound_set_volume(sound, m_baseVolume[command.sound] * gain);
+        ma_sound_seek_to_pcm_frame(sound, 0);
+        ma_sound_start(sound);
+    }
+}
+
+// Device data callback: runs on the audio thread for every period.
+// It must finish within the time the period covers, otherwise the device runs out of audio.
+void AudioSystem::dataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    AudioSystem* audio = static_cast<AudioSystem*>(pDevice->pUserData);
+    if (!audio->m_engineReady) return;
+
+    PROFILE_SCOPE("audio callback"); // Shows up as its own thread in the trace
+    ALLOC_SCOPE("audio callback");   // The audio thread must never allocate
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double budgetSeconds = static_cast<double>(frameCount) / pDevice->sampleRate;
+
+    // Detect underruns from the spacing between callbacks
+    if (audio->m_hasLastCallback) {
+        double gapSeconds = std::chrono::duration<double>(start - audio->m_lastCallbackStart).count();
+        if (gapSeconds > audio->m_lastBudgetSeconds * XRUN_GAP_FACTOR) {
+            metricAdd(METRIC_AUDIO_XRUNS, 1);
+        }
+    }
+    audio->m_hasLastCallback = true;
+    audio->m_lastCallbackStart = start;
+    audio->m_lastBudgetSeconds = budgetSeconds;
+
+    audio->processCommands();
+    if (audio->m_musicReady.load(std::memory_order_acquire)) {
+        audio->m_music.refill(); // Decode ahead of this period's mix
+    }
+    ma_engine_read_pcm_frames(&audio->m_engine, pOutput, frameCount, NULL);
+
+    // Publish how much of the budget this callback used
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    metricAdd(METRIC_AUDIO_CALLBACKS, 1);
+    metricSet(METRIC_AUDIO_CALLBACK_MS, elapsedSeconds * 1000.0);
+    metricMax(METRIC_AUDIO_CALLBACK_MAX_MS, elapsedSeconds * 1000.0);
+    metricSet(METRIC_AUDIO_BUDGET_MS, budgetSeconds * 1000.0);
+    metricSet(METRIC_AUDIO_LOAD, elapsedSeconds / budgetSeconds);
+    if (elapsedSeconds > budgetSeconds) {
+        metricAdd(METRIC_AUDIO_OVERRUNS, 1);
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef AUDIO_SYSTEM_H
+#define AUDIO_SYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// miniaudio is implemented in main.cpp, here we only need its declarations
+#include "../miniaudio.h"
+#include "music_stream.h"
+
+// Identifiers for every sound effect the game can trigger
+enum SoundID {
+    SOUND_CORRECT_CATCH = 0,
+    SOUND_WRONG_CATCH,
+    NUM_SOUNDS
+};
+
+// A single request sent from the game thread to the audio thread.
+// count: how many identical triggers were merged into this command during one tick.
+struct AudioCommand {
+    SoundID sound;
+    unsigned int count;
+};
+
+// Fixed-size single-producer / single-consumer ring buffer.
+// The game thread is the only producer and the audio thread the only consumer,
+// so two atomic indices are enough and neither side ever blocks.
+template <size_t Capacity>
+class AudioCommandQueue {
+private:
+    AudioCommand buffer[Capacity];
+    std::atomic<size_t> head; // Next slot to read (owned by the consumer)
+    std::atomic<size_t> tail; // Next slot to write (owned by the producer)
+
+public:
+    AudioCommandQueue() : head(0), tail(0) {}
+
+    // Producer side. Returns false if the queue is full (command is dropped).
+    bool push(const AudioCommand& command) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        size_t nextTail = (currentTail + 1) % Capacity;
+        if (nextTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        buffer[currentTail] = command;
+        tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if there is nothing to read.
+    bool pop(AudioCommand& command) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        command = buffer[currentHead];
+        head.store((currentHead + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+};
+
+// Owns the miniaudio engine, its playback device and all sound effects.
+// Game code only calls trigger() and flush(); every miniaudio call that touches
+// a sound happens on the audio thread inside the device data callback.
+// The callback is timed against its period budget and the results are published as METRIC_AUDIO_* metrics.
+class AudioSystem {
+public:
+    AudioSystem();
+    ~AudioSystem();
+
+    bool init();                                                    // Creates the device and the engine
+    bool initOffline(const char* wavPath, ma_uint32 sampleRate = 48000, ma_uint32 channels = 2); // No device, mix into a WAV file
+    bool loadSound(SoundID id, const char* path, float volume);    // Loads a fully decoded sound effect
+    bool playMusic(const char* path, float volume);                 // Starts looping background music, streamed from disk
+
+    void trigger(SoundID id);   // Game thread: request a sound for the current tick
+    void flush();               // Game thread: end of tick, send the merged requests to the audio thread
+    void advance(float deltaTime); // Offline mode only: mixes exactly deltaTime worth of audio into the WAV file
+
+    bool isReady() const { return m_engineReady; }
+    bool isOffline() const { return m_offline; }
+
+private:
+    static void dataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
+    void processCommands();     // Audio thread: drains the queue and starts the requested sounds
+    void trackMemory(double bytes); // Adds to the audio row of the memory report
+
+    ma_device m_device;
+    ma_engine m_engine;
+    bool m_deviceReady;
+    bool m_engineReady;
+
+    // Offline rendering: the game thread pulls mixed frames in lockstep with the simulation
+    static const ma_uint32 OFFLINE_CHUNK_FRAMES = 1024;
+    bool m_offline;
+    ma_encoder m_encoder;
+    bool m_encoderReady;
+    ma_uint32 m_offlineChannels;
+    double m_offlineFrameDebt;     // Fractional frames carried over between ticks
+    float* m_offlineBuffer;        // OFFLINE_CHUNK_FRAMES * channels scratch samples
+
+    ma_sound m_sounds[NUM_SOUNDS];
+    bool m_soundLoaded[NUM_SOUNDS];
+    float m_baseVolume[NUM_SOUNDS];
+
+    // Background music: decoded on the audio thread, only once m_musicReady is set
+    MusicStream m_music;
+    ma_sound m_musicSound;
+    bool m_musicLoaded;
+    std::atomic<bool> m_musicReady;
+
+    unsigned int m_pendingTriggers[NUM_SOUNDS]; // Triggers collected during the current tick (game thread only)
+    AudioCommandQueue<64> m_commandQueue;
+
+    // Callback timing (audio thread only)
+    bool m_hasLastCallback;
+    std::chrono::steady_clock::time_point m_lastCallbackStart;
+    double m_lastBudgetSeconds;
+
+    double m_trackedBytes;      // Decoded sounds and buffers added to the memory report, removed by the destructor
+};
+
+#endif // AUDIO_SYSTEM_H
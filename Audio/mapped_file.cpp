@@ -0,0 +1,98 @@
+#include "mapped_file.h" // Include the corresponding header file
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_fileHandle(INVALID_HANDLE_VALUE), m_mappingHandle(NULL) {}
+
+// Opens the file and maps all of it read-only.
+bool MappedFile::open(const char* path) {
+    close();
+
+    m_fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    m_mappingHandle = CreateFileMappingA(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mappingHandle == NULL) {
+        close();
+        return false;
+    }
+
+    m_data = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == nullptr) {
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+// Releases the view, the mapping object and the file, in reverse order of creation.
+void MappedFile::close() {
+    if (m_data != nullptr) UnmapViewOfFile(m_data);
+    if (m_mappingHandle != NULL) CloseHandle(m_mappingHandle);
+    if (m_fileHandle != INVALID_HANDLE_VALUE) CloseHandle(m_fileHandle);
+    m_data = nullptr;
+    m_size = 0;
+    m_mappingHandle = NULL;
+    m_fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_fileDescriptor(-1) {}
+
+// Opens the file and maps all of it read-only.
+bool MappedFile::open(const char* path) {
+    close();
+
+    m_fileDescriptor = ::open(path, O_RDONLY);
+    if (m_fileDescriptor < 0) return false;
+
+    struct stat fileInfo;
+    if (fstat(m_fileDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void* mapped = mmap(NULL, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    m_data = mapped;
+    m_size = static_cast<size_t>(fileInfo.st_size);
+    return true;
+}
+
+// Unmaps the file and closes its descriptor.
+void MappedFile::close() {
+    if (m_data != nullptr) munmap(const_cast<void*>(m_data), m_size);
+    if (m_fileDescriptor >= 0) ::close(m_fileDescriptor);
+    m_data = nullptr;
+    m_size = 0;
+    m_fileDescriptor = -1;
+}
+
+#endif
+
+// Destructor: Unmaps the file if it's still open.
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file.
+// The OS pages the file in on demand, so mapping a large file costs no RAM up front.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const char* path);    // Maps the file, returns false on failure
+    void close();                   // Unmaps the file (also done by the destructor)
+
+    const void* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+
+private:
+    // Not copyable, the mapping has a single owner
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const void* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_fileHandle;     // HANDLE of the opened file
+    void* m_mappingHandle;  // HANDLE of the file mapping object
+#else
+    int m_fileDescriptor;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,139 @@
+#include "music_stream.h" // Include the corresponding header file
+
+#include <iostream>
+#include <cstring>
+
+#include "../Metrics/metrics.h"
+
+// Only the callbacks we need, miniaudio treats the NULL entries as "not implemented"
+const ma_data_source_vtable MusicStream::s_vtable = {
+    MusicStream::onRead,
+    MusicStream::onSeek,
+    MusicStream::onGetDataFormat,
+    NULL,   // onGetCursor
+    NULL,   // onGetLength
+    NULL,   // onSetLooping
+    0       // flags
+};
+
+MusicStream::MusicStream() : m_channels(0), m_sampleRate(0), m_open(false) {
+    m_source.owner = this;
+}
+
+MusicStream::~MusicStream() {
+    close();
+}
+
+// Maps the file, creates a decoder converting straight to the engine's format and fills the ring once.
+bool MusicStream::open(const char* path, ma_uint32 channels, ma_uint32 sampleRate) {
+    close();
+
+    if (!m_file.open(path)) {
+        std::cerr << "Failed to map music file: " << path << std::endl;
+        return false;
+    }
+
+    // The decoder reads the compressed bytes directly from the mapping, nothing is copied
+    ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, channels, sampleRate);
+    if (ma_decoder_init_memory(m_file.data(), m_file.size(), &decoderConfig, &m_decoder) != MA_SUCCESS) {
+        std::cerr << "Failed to create music decoder for: " << path << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    if (ma_pcm_rb_init(ma_format_f32, channels, RING_FRAMES, NULL, NULL, &m_ring) != MA_SUCCESS) {
+        std::cerr << "Failed to allocate music ring buffer." << std::endl;
+        ma_decoder_uninit(&m_decoder);
+        m_file.close();
+        return false;
+    }
+
+    ma_data_source_config sourceConfig = ma_data_source_config_init();
+    sourceConfig.vtable = &s_vtable;
+    ma_data_source_init(&sourceConfig, &m_source.base);
+
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+    m_open = true;
+    refill(); // Nothing else is using the stream yet, so it is safe to pre-fill it here
+
+    std::cout << "Streaming music: " << path << " (" << m_file.size() << " bytes mapped)" << std::endl;
+    return true;
+}
+
+// Releases the decoder, ring buffer and file mapping.
+void MusicStream::close() {
+    if (!m_open) return;
+    ma_data_source_uninit(&m_source.base);
+    ma_pcm_rb_uninit(&m_ring);
+    ma_decoder_uninit(&m_decoder);
+    m_file.close();
+    m_open = false;
+}
+
+// Decodes fixed-size chunks into the ring until it's full. Wraps back to the
+// start of the track when the decoder runs out, so the music loops seamlessly.
+void MusicStream::refill() {
+    if (!m_open) return;
+
+    while (ma_pcm_rb_available_write(&m_ring) > 0) {
+        ma_uint32 framesToWrite = DECODE_CHUNK_FRAMES;
+        void* writeBuffer;
+        if (ma_pcm_rb_acquire_write(&m_ring, &framesToWrite, &writeBuffer) != MA_SUCCESS || framesToWrite == 0) break;
+
+        ma_uint64 framesDecoded = 0;
+        ma_decoder_read_pcm_frames(&m_decoder, writeBuffer, framesToWrite, &framesDecoded);
+        ma_pcm_rb_commit_write(&m_ring, static_cast<ma_uint32>(framesDecoded));
+
+        if (framesDecoded < framesToWrite) {
+            // End of track: start over. Stop if the track is empty to avoid spinning forever.
+            if (ma_decoder_seek_to_pcm_frame(&m_decoder, 0) != MA_SUCCESS || framesDecoded == 0) break;
+        }
+    }
+}
+
+// Called by the engine on the audio thread: copies decoded frames out of the ring.
+// If the ring runs short the rest is filled with silence so the sound keeps playing.
+ma_result MusicStream::onRead(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead) {
+    MusicStream* stream = reinterpret_cast<Source*>(pDataSource)->owner;
+    float* output = static_cast<float*>(pFramesOut);
+    ma_uint64 framesRead = 0;
+
+    while (framesRead < frameCount) {
+        ma_uint32 framesToRead = static_cast<ma_uint32>(frameCount - framesRead);
+        void* readBuffer;
+        if (ma_pcm_rb_acquire_read(&stream->m_ring, &framesToRead, &readBuffer) != MA_SUCCESS || framesToRead == 0) break;
+
+        memcpy(output + framesRead * stream->m_channels, readBuffer, framesToRead * stream->m_channels * sizeof(float));
+        ma_pcm_rb_commit_read(&stream->m_ring, framesToRead);
+        framesRead += framesToRead;
+    }
+
+    if (framesRead < frameCount) {
+        memset(output + framesRead * stream->m_channels, 0, (frameCount - framesRead) * stream->m_channels * sizeof(float));
+        metricAdd(METRIC_AUDIO_MUSIC_UNDERRUNS, 1);
+    }
+
+    if (pFramesRead) *pFramesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+// Seeking restarts decoding from the requested frame and drops what was buffered.
+ma_result MusicStream::onSeek(ma_data_source* pDataSource, ma_uint64 frameIndex) {
+    MusicStream* stream = reinterpret_cast<Source*>(pDataSource)->owner;
+    ma_result result = ma_decoder_seek_to_pcm_frame(&stream->m_decoder, frameIndex);
+    if (result == MA_SUCCESS) {
+        ma_pcm_rb_reset(&stream->m_ring);
+    }
+    return result;
+}
+
+// Reports the format the decoder was configured to output (always the engine's format).
+ma_result MusicStream::onGetDataFormat(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap) {
+    MusicStream* stream = reinterpret_cast<Source*>(pDataSource)->owner;
+    if (pFormat) *pFormat = ma_format_f32;
+    if (pChannels) *pChannels = stream->m_channels;
+    if (pSampleRate) *pSampleRate = stream->m_sampleRate;
+    if (pChannelMap) ma_channel_map_init_standard(ma_standard_channel_map_default, pChannelMap, channelMapCap, stream->m_channels);
+    return MA_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+
+#include "../miniaudio.h"
+#include "mapped_file.h"
+
+// Looping background music streamed from a compressed file (FLAC, MP3 or WAV).
+// The file is memory-mapped and decoded a small chunk at a time on the audio thread
+// into a fixed-size ring buffer, so the whole track is never decoded into RAM.
+// The stream is exposed to the engine as a miniaudio data source reading from that ring.
+class MusicStream {
+public:
+    static const ma_uint32 RING_FRAMES = 8192;     // Decoded frames kept ahead of playback (~170 ms at 48 kHz)
+    static const ma_uint32 DECODE_CHUNK_FRAMES = 1024; // Frames decoded per step when topping up the ring
+
+    MusicStream();
+    ~MusicStream();
+
+    bool open(const char* path, ma_uint32 channels, ma_uint32 sampleRate); // Maps the file and prepares the decoder
+    void close();
+
+    void refill();  // Audio thread: decodes chunks until the ring is full, loops at the end of the track
+
+    ma_data_source* getDataSource() { return &m_source; }
+    bool isOpen() const { return m_open; }
+
+private:
+    // The data source handed to ma_sound; miniaudio requires ma_data_source_base as the first member
+    struct Source {
+        ma_data_source_base base;
+        MusicStream* owner;
+    };
+
+    static const ma_data_source_vtable s_vtable;
+    static ma_result onRead(ma_data_source* pDataSource, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead);
+    static ma_result onSeek(ma_data_source* pDataSource, ma_uint64 frameIndex);
+    static ma_result onGetDataFormat(ma_data_source* pDataSource, ma_format* pFormat, ma_uint32* pChannels, ma_uint32* pSampleRate, ma_channel* pChannelMap, size_t channelMapCap);
+
+    Source m_source;
+    MappedFile m_file;
+    ma_decoder m_decoder;
+    ma_pcm_rb m_ring;
+    ma_uint32 m_channels;
+    ma_uint32 m_sampleRate;
+    bool m_open;
+};
+
+#endif // MUSIC_STREAM_H
@@ -0,0 +1,78 @@
+#include "benchmark.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+BenchmarkRunner::BenchmarkRunner(const std::string& filter) : m_filter(filter) {}
+
+void BenchmarkRunner::run(const std::string& name, int samples, int repeat, const std::function<void()>& body,
+    const std::function<void()>& setup, const std::function<void()>& teardown) {
+    if (!m_filter.empty() && name.find(m_filter) == std::string::npos) return;
+
+    std::vector<double> times; // Per call, in ns
+    times.reserve(samples);
+    for (int sample = -1; sample < samples; ++sample) { // Sample -1 is the warm-up
+        if (setup) setup();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i) {
+            body();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if (teardown) teardown();
+        if (sample >= 0) {
+            times.push_back(std::chrono::duration<double, std::nano>(end - start).count() / repeat);
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = samples;
+    result.repeat = repeat;
+    result.minNs = times.front();
+    result.maxNs = times.back();
+    result.medianNs = times.size() % 2 == 1 ? times[times.size() / 2]
+        : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+    result.p90Ns = times[std::min(times.size() - 1, static_cast<size_t>(times.size() * 0.9))];
+
+    double sum = 0.0;
+    for (double t : times) sum += t;
+    result.meanNs = sum / times.size();
+    double squares = 0.0;
+    for (double t : times) squares += (t - result.meanNs) * (t - result.meanNs);
+    result.stddevNs = std::sqrt(squares / times.size());
+
+    std::cout << std::left << std::setw(40) << name << std::right << " median " << std::fixed << std::setprecision(1)
+        << std::setw(14) << result.medianNs << " ns  (min " << result.minNs << ", p90 " << result.p90Ns << ")" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    m_results.push_back(result);
+}
+
+// One object per case, in the order they ran. Names are plain ASCII paths, so no escaping is needed.
+bool BenchmarkRunner::writeJson(const char* path, const std::string& label) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open benchmark output file: " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(1);
+    out << "{\n  \"label\": \"" << label << "\",\n  \"unit\": \"ns\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& r = m_results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"samples\": " << r.samples << ", \"repeat\": " << r.repeat
+            << ", \"median\": " << r.medianNs << ", \"min\": " << r.minNs << ", \"mean\": " << r.meanNs
+            << ", \"p90\": " << r.p90Ns << ", \"max\": " << r.maxNs << ", \"stddev\": " << r.stddevNs << "}"
+            << (i + 1 < m_results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+
+    std::cout << "Wrote " << m_results.size() << " benchmark results to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness.
+// Each case runs one untimed warm-up sample, then 'samples' timed samples of 'repeat' calls each.
+// Results are reported per call, and the median is the number to compare between commits
+// (it ignores the odd sample disturbed by the OS or the driver).
+struct BenchmarkResult {
+    std::string name;
+    int samples;
+    int repeat;         // Calls per sample
+    double minNs;       // All times are per call
+    double medianNs;
+    double meanNs;
+    double p90Ns;
+    double maxNs;
+    double stddevNs;
+};
+
+class BenchmarkRunner {
+public:
+    // Only cases whose name contains filter run (empty runs everything)
+    explicit BenchmarkRunner(const std::string& filter = "");
+
+    // setup and teardown run around every sample and aren't timed (either may be empty)
+    void run(const std::string& name, int samples, int repeat, const std::function<void()>& body,
+        const std::function<void()>& setup = std::function<void()>(),
+        const std::function<void()>& teardown = std::function<void()>());
+
+    bool writeJson(const char* path, const std::string& label) const;
+    const std::vector<BenchmarkResult>& getResults() const { return m_results; }
+
+private:
+    std::string m_filter;
+    std::vector<BenchmarkResult> m_results;
+};
+
+#endif // BENCHMARK_H
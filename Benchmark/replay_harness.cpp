@@ -0,0 +1,186 @@
+#include "replay_harness.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+const double ReplayHarness::COUNTER_TOLERANCE = 0.01;
+
+static const double MAD_TO_SIGMA = 1.4826; // MAD of a normal distribution times this is its standard deviation
+
+static double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+static double medianAbsoluteDeviation(const std::vector<double>& values) {
+    double center = median(values);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) deviations.push_back(std::fabs(v - center));
+    return median(deviations);
+}
+
+static double percentile(std::vector<float>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * p))];
+}
+
+ReplayHarness::ReplayHarness(double tolerance) : m_tolerance(tolerance) {}
+
+void ReplayHarness::addValue(const std::string& session, const char* name, bool timing, double value) {
+    for (Stat& stat : m_stats) {
+        if (stat.session == session && stat.name == name) {
+            stat.runs.push_back(value);
+            return;
+        }
+    }
+    Stat stat;
+    stat.session = session;
+    stat.name = name;
+    stat.timing = timing;
+    stat.runs.push_back(value);
+    m_stats.push_back(stat);
+}
+
+bool ReplayHarness::addRun(const std::string& session, const std::vector<ReplayFrameSample>& frames) {
+    if (frames.empty()) {
+        std::cerr << "Replay run of " << session << " measured no ticks (is the session longer than the warm-up?)" << std::endl;
+        return false;
+    }
+
+    std::vector<float> update, draw, frame;
+    double drawCalls = 0.0, vertices = 0.0, stateChanges = 0.0, uploadBytes = 0.0, allocs = 0.0, peakParticles = 0.0;
+    for (const ReplayFrameSample& f : frames) {
+        update.push_back(f.updateMs);
+        draw.push_back(f.drawMs);
+        frame.push_back(f.frameMs);
+        drawCalls += f.drawCalls;
+        vertices += f.vertices;
+        stateChanges += f.stateChanges;
+        uploadBytes += f.uploadBytes;
+        allocs += f.allocs;
+        peakParticles = std::max(peakParticles, static_cast<double>(f.liveParticles));
+    }
+    std::sort(update.begin(), update.end());
+    std::sort(draw.begin(), draw.end());
+    std::sort(frame.begin(), frame.end());
+    double count = static_cast<double>(frames.size());
+
+    addValue(session, "update_ms_p50", true, percentile(update, 0.50));
+    addValue(session, "update_ms_p95", true, percentile(update, 0.95));
+    addValue(session, "update_ms_p99", true, percentile(update, 0.99));
+    addValue(session, "draw_ms_p50", true, percentile(draw, 0.50));
+    addValue(session, "draw_ms_p95", true, percentile(draw, 0.95));
+    addValue(session, "draw_ms_p99", true, percentile(draw, 0.99));
+    addValue(session, "frame_ms_p50", true, percentile(frame, 0.50));
+    addValue(session, "frame_ms_p95", true, percentile(frame, 0.95));
+    addValue(session, "frame_ms_p99", true, percentile(frame, 0.99));
+    addValue(session, "draw_calls_mean", false, drawCalls / count);
+    addValue(session, "vertices_mean", false, vertices / count);
+    addValue(session, "state_changes_mean", false, stateChanges / count);
+    addValue(session, "upload_bytes_mean", false, uploadBytes / count);
+    addValue(session, "allocs_total", false, allocs);
+    addValue(session, "live_particles_peak", false, peakParticles);
+    return true;
+}
+
+bool ReplayHarness::writeResults(const char* path, const std::string& label) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open replay results file: " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(6);
+    out << "{\n  \"label\": \"" << label << "\",\n  \"tolerance\": " << m_tolerance << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        const Stat& s = m_stats[i];
+        out << "    {\"session\": \"" << s.session << "\", \"stat\": \"" << s.name << "\", \"timing\": "
+            << (s.timing ? "true" : "false") << ", \"median\": " << median(s.runs) << ", \"mad\": "
+            << medianAbsoluteDeviation(s.runs) << ", \"runs\": " << s.runs.size() << "}"
+            << (i + 1 < m_stats.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+
+    std::cout << "Wrote " << m_stats.size() << " replay statistics to " << path << std::endl;
+    return true;
+}
+
+bool ReplayHarness::compare(const char* baselinePath, std::ostream& report) const {
+    struct BaselineStat {
+        std::string session, name;
+        double median, mad;
+    };
+    std::vector<BaselineStat> baseline;
+
+    std::ifstream in(baselinePath);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open replay baseline: " << baselinePath << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        char session[256], name[64], timing[8];
+        BaselineStat stat;
+        if (sscanf(line.c_str(), " {\"session\": \"%255[^\"]\", \"stat\": \"%63[^\"]\", \"timing\": %7[a-z], \"median\": %lf, \"mad\": %lf",
+                session, name, timing, &stat.median, &stat.mad) == 5) {
+            stat.session = session;
+            stat.name = name;
+            baseline.push_back(stat);
+        }
+    }
+    if (baseline.empty()) {
+        std::cerr << "Replay baseline has no results: " << baselinePath << std::endl;
+        return false;
+    }
+
+    int regressions = 0;
+    report << std::left << std::setw(24) << "session" << std::setw(22) << "stat" << std::right
+        << std::setw(14) << "baseline" << std::setw(14) << "current" << std::setw(14) << "limit" << "  result" << std::endl;
+    report << std::fixed << std::setprecision(4);
+    for (const Stat& s : m_stats) {
+        double current = median(s.runs);
+        const BaselineStat* base = nullptr;
+        for (const BaselineStat& b : baseline) {
+            if (b.session == s.session && b.name == s.name) base = &b;
+        }
+
+        report << std::left << std::setw(24) << s.session << std::setw(22) << s.name << std::right;
+        if (base == nullptr) {
+            report << std::setw(14) << "-" << std::setw(14) << current << std::setw(14) << "-" << "  NEW" << std::endl;
+            continue;
+        }
+
+        double limit;
+        if (s.timing) {
+            double noise = NOISE_SIGMAS * MAD_TO_SIGMA * std::max(base->mad, medianAbsoluteDeviation(s.runs));
+            limit = base->median * (1.0 + m_tolerance) + noise;
+        }
+        else {
+            limit = base->median * (1.0 + COUNTER_TOLERANCE);
+        }
+        const char* result = "ok";
+        if (current > limit) {
+            result = "FAIL";
+            regressions++;
+        }
+        else if (s.timing && current < base->median * (1.0 - m_tolerance)) {
+            result = "faster";
+        }
+        report << std::setw(14) << base->median << std::setw(14) << current << std::setw(14) << limit << "  " << result << std::endl;
+    }
+    report.unsetf(std::ios::floatfield);
+
+    if (regressions > 0) {
+        report << "Replay regression check FAILED: " << regressions << " statistics above their limit." << std::endl;
+        return false;
+    }
+    report << "Replay regression check passed (tolerance " << m_tolerance * 100.0 << "%)." << std::endl;
+    return true;
+}
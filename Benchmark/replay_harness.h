@@ -0,0 +1,56 @@
+#ifndef REPLAY_HARNESS_H
+#define REPLAY_HARNESS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What the replay loop measures in one tick
+struct ReplayFrameSample {
+    float updateMs;         // Input and Game::update
+    float drawMs;           // CPU time of Game::draw
+    float frameMs;          // Whole tick, GPU included (the loop waits for it with glFinish)
+    float drawCalls;
+    float vertices;
+    float stateChanges;
+    float uploadBytes;
+    float allocs;           // Only counted in TRACK_ALLOCATIONS builds
+    float liveParticles;
+};
+
+// Frame-time regression gate for recorded sessions.
+// Every session is replayed several times; each run is reduced to a few statistics
+// (timing percentiles, counter means), and across runs each statistic keeps its median and its
+// median absolute deviation (MAD). A timing statistic regresses when its median is above the baseline
+// by more than the relative tolerance plus three standard deviations of run-to-run noise (from the MADs).
+// Counters don't depend on timing, so they only get COUNTER_TOLERANCE.
+class ReplayHarness {
+public:
+    static const int NOISE_SIGMAS = 3;
+    static const double COUNTER_TOLERANCE;
+
+    explicit ReplayHarness(double tolerance = 0.10);
+
+    // Returns false (and records nothing) for a run without measured ticks: no data must never pass the gate
+    bool addRun(const std::string& session, const std::vector<ReplayFrameSample>& frames);
+
+    // One statistic per line, so compare() can read it back as a baseline without a JSON library
+    bool writeResults(const char* path, const std::string& label) const;
+    // Prints one row per statistic; returns false if anything regressed or the baseline can't be read
+    bool compare(const char* baselinePath, std::ostream& report) const;
+
+private:
+    struct Stat {
+        std::string session;
+        std::string name;
+        bool timing;
+        std::vector<double> runs;   // One value per run
+    };
+
+    void addValue(const std::string& session, const char* name, bool timing, double value);
+
+    std::vector<Stat> m_stats;
+    double m_tolerance;
+};
+
+#endif // REPLAY_HARNESS_H
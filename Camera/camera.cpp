@@ -1,85 +1,128 @@
 #include "camera.h" // Include the corresponding header file
 
 // Constructor implementation
-// Initializes the camera's position, view direction, and up vector using an initializer list.
+// Builds the orientation quaternion from the initial view direction and up vector.
 Camera::Camera(glm::vec3 initialPosition, glm::vec3 initialViewDirection, glm::vec3 initialUp)
-    : position(initialPosition), viewDirection(initialViewDirection), up(initialUp)
+    : position(initialPosition), projection(1.0f), viewDirty(true), viewProjectionDirty(true), version(0)
 {
-    // Any additional initialization logic for the camera can go here.
-    // For example, normalizing vectors if they aren't guaranteed to be normalized on input.
-    // Or setting up initial camera matrices if you were storing them as members.
-    viewDirection = glm::normalize(viewDirection);
-    up = glm::normalize(up);
+    // Camera space looks down -Z with +Y up, so the camera basis in world space is
+    // (right, up, -viewDirection). The rotation taking one to the other is our orientation.
+    glm::vec3 forward = glm::normalize(initialViewDirection);
+    glm::vec3 right = glm::normalize(glm::cross(forward, initialUp));
+    glm::vec3 up = glm::cross(right, forward);
+    orientation = glm::normalize(glm::quat_cast(glm::mat3(right, up, -forward)));
+}
+
+// The view direction is camera space -Z rotated into world space
+glm::vec3 Camera::getViewDirection() const
+{
+    return orientation * glm::vec3(0.0f, 0.0f, -1.0f);
+}
+
+// The up vector is camera space +Y rotated into world space
+glm::vec3 Camera::getUp() const
+{
+    return orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+void Camera::setPosition(const glm::vec3& newPosition)
+{
+    position = newPosition;
+    markViewChanged();
+}
+
+// Invalidates the cached matrices that depend on position/orientation
+void Camera::markViewChanged()
+{
+    viewDirty = true;
+    viewProjectionDirty = true;
+    version++;
 }
 
 // Moves the camera forward along its view direction
 void Camera::keyboardMoveFront(float cameraSpeed)
 {
-    position += viewDirection * cameraSpeed * 50.0f; // Multiplier 50.0f for faster movement
+    setPosition(position + getViewDirection() * cameraSpeed * 50.0f); // Multiplier 50.0f for faster movement
 }
 
 // Moves the camera backward along its view direction
 void Camera::keyboardMoveBack(float cameraSpeed)
 {
-    position -= viewDirection * cameraSpeed * 50.0f; // Multiplier 50.0f for faster movement
+    setPosition(position - getViewDirection() * cameraSpeed * 50.0f); // Multiplier 50.0f for faster movement
 }
 
 // Moves the camera left (strafing)
-// This requires calculating a 'right' vector, which is perpendicular to viewDirection and up.
+// The local right vector is camera space +X rotated into world space.
 void Camera::keyboardMoveLeft(float cameraSpeed)
 {
-    // Calculate the right vector (cross product of viewDirection and up)
-    // and normalize it to ensure consistent speed.
-    glm::vec3 right = glm::normalize(glm::cross(viewDirection, up));
-    position -= right * cameraSpeed * 50.0f; // Move left
+    glm::vec3 right = orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+    setPosition(position - right * cameraSpeed * 50.0f); // Move left
 }
 
 // Moves the camera right (strafing)
 void Camera::keyboardMoveRight(float cameraSpeed)
 {
-    // Calculate the right vector (cross product of viewDirection and up)
-    // and normalize it to ensure consistent speed.
-    glm::vec3 right = glm::normalize(glm::cross(viewDirection, up));
-    position += right * cameraSpeed * 50.0f; // Move right
+    glm::vec3 right = orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+    setPosition(position + right * cameraSpeed * 50.0f); // Move right
 }
 
 // Moves the camera upward along its local up vector
 void Camera::keyboardMoveUp(float cameraSpeed)
 {
-    position += up * cameraSpeed;
+    setPosition(position + getUp() * cameraSpeed);
 }
 
 // Moves the camera downward along its local up vector
 void Camera::keyboardMoveDown(float cameraSpeed)
 {
-    position -= up * cameraSpeed;
+    setPosition(position - getUp() * cameraSpeed);
 }
 
 // Rotates the camera around its local X-axis (pitch)
-// This will change the viewDirection and potentially the up vector.
+// Multiplying on the right applies the rotation in camera space, so the axis is always the current right vector.
+// The angle uses the same convention as the glm::rotate call this replaced.
 void Camera::rotateOx(float angle)
 {
-    // Calculate the right vector, which is the axis of rotation for pitching
-    glm::vec3 right = glm::normalize(glm::cross(viewDirection, up));
-
-    // Create a rotation matrix around the 'right' vector
-    glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(angle), right);
-
-    // Apply the rotation to the viewDirection and up vector
-    viewDirection = glm::normalize(glm::vec3(rotationMatrix * glm::vec4(viewDirection, 0.0f)));
-    up = glm::normalize(glm::vec3(rotationMatrix * glm::vec4(up, 0.0f)));
+    orientation = glm::normalize(orientation * glm::angleAxis(glm::radians(angle), glm::vec3(1.0f, 0.0f, 0.0f)));
+    markViewChanged();
 }
 
 // Rotates the camera around its local Y-axis (yaw)
-// This rotates around the global Y-axis or the camera's current 'up' vector.
 void Camera::rotateOy(float angle)
 {
-    // Create a rotation matrix around the 'up' vector (yaw axis)
-    // Using the camera's own up vector for local yaw.
-    glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(angle), up);
+    orientation = glm::normalize(orientation * glm::angleAxis(glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f)));
+    markViewChanged();
+}
 
-    // Apply the rotation to the viewDirection
-    viewDirection = glm::normalize(glm::vec3(rotationMatrix * glm::vec4(viewDirection, 0.0f)));
-    // Note: The 'up' vector might not need to be updated if you're rotating purely around it.
-    // However, if you are also changing pitch, the 'up' vector would have been updated by rotateOx.
-}
\ No newline at end of file
+// Sets an orthographic projection. It's computed right away since it only changes on resize.
+void Camera::setOrthographic(float left, float right, float bottom, float top, float zNear, float zFar)
+{
+    projection = glm::ortho(left, right, bottom, top, zNear, zFar);
+    viewProjectionDirty = true;
+    version++;
+}
+
+// Returns the view matrix, rebuilding it only if the camera moved or rotated
+const glm::mat4& Camera::getView() const
+{
+    if (viewDirty) {
+        view = glm::lookAt(position, position + getViewDirection(), getUp());
+        viewDirty = false;
+    }
+    return view;
+}
+
+const glm::mat4& Camera::getProjection() const
+{
+    return projection;
+}
+
+// Returns projection * view, rebuilding it only if either of them changed
+const glm::mat4& Camera::getViewProjection() const
+{
+    if (viewProjectionDirty) {
+        viewProjection = projection * getView();
+        viewProjectionDirty = false;
+    }
+    return viewProjection;
+}
@@ -5,19 +5,12 @@
 // Make sure these paths are correct relative to your project setup
 #include "../dependente/glm/glm.hpp"
 #include "../dependente/glm/gtc/matrix_transform.hpp"
+#include "../dependente/glm/gtc/quaternion.hpp"
 #include "../dependente/glm/gtc/type_ptr.hpp" // Included for potential glm::value_ptr usage if needed
 
 class Camera
 {
 public:
-    // Camera properties:
-    // position: The current location of the camera in world space.
-    // viewDirection: A normalized vector indicating where the camera is looking.
-    // up: A normalized vector indicating the camera's "up" direction (usually (0, 1, 0) for a standard camera).
-    glm::vec3 position;
-    glm::vec3 viewDirection;
-    glm::vec3 up;
-
     // Constructor: Initializes the camera with its position, view direction, and up vector.
     // The implementation for this constructor will be in camera.cpp.
     Camera(glm::vec3 position, glm::vec3 viewDirection, glm::vec3 up);
@@ -35,6 +28,41 @@ public:
     // These functions rotate the camera around its local X (pitch) and Y (yaw) axes.
     void rotateOx(float angle); // Rotate around local X-axis (pitch)
     void rotateOy(float angle); // Rotate around local Y-axis (yaw)
+
+    // Projection: an orthographic box, in world units, relative to the camera.
+    void setOrthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+
+    // Camera properties:
+    // position: The current location of the camera in world space.
+    // viewDirection / up: Normalized vectors derived from the orientation quaternion.
+    glm::vec3 getPosition() const { return position; }
+    glm::vec3 getViewDirection() const;
+    glm::vec3 getUp() const;
+    void setPosition(const glm::vec3& newPosition);
+
+    // Cached matrices: only recomputed after something they depend on has changed.
+    const glm::mat4& getView() const;
+    const glm::mat4& getProjection() const;
+    const glm::mat4& getViewProjection() const;
+
+    // Increases every time the view or the projection changes.
+    // Consumers remember the last version they used and skip their work while it's the same.
+    unsigned int getVersion() const { return version; }
+
+private:
+    glm::vec3 position;
+    glm::quat orientation;  // Rotation from camera space (looking down -Z, Y up) to world space
+
+    // Matrix cache, filled lazily by the getters
+    mutable glm::mat4 view;
+    mutable glm::mat4 projection;
+    mutable glm::mat4 viewProjection;
+    mutable bool viewDirty;
+    mutable bool viewProjectionDirty;
+
+    unsigned int version;
+
+    void markViewChanged();     // Call after position or orientation changed
 };
 
-#endif // CAMERA_H
\ No newline at end of file
+#endif // CAMERA_H
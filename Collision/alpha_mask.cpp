@@ -0,0 +1,135 @@
+#include "alpha_mask.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <iostream>
+
+#include "../stb_image.h"
+#include "../Profiler/memory_report.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+static const int ALPHA_THRESHOLD = 128; // Average alpha a cell needs to count as opaque
+
+static int popcount64(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(bits));
+#else
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((bits * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 64 bits of a packed row starting at bit 'start'. Bits before the row or past its end read as 0,
+// so start may be negative or beyond the last word.
+static uint64_t rowBitsAt(const uint64_t* row, int words, int start) {
+    int word = start >= 0 ? start / 64 : -((63 - start) / 64); // Rounded down, also for negative starts
+    int shift = start - word * 64;
+    uint64_t bits = 0;
+    if (word >= 0 && word < words) bits = row[word] >> shift;
+    if (shift != 0 && word + 1 >= 0 && word + 1 < words) bits |= row[word + 1] << (64 - shift);
+    return bits;
+}
+
+AlphaMask::AlphaMask() : m_width(0), m_height(0), m_wordsPerRow(0) {}
+
+AlphaMask::~AlphaMask() {
+    memoryAdd(MEMORY_TEXTURES, -static_cast<double>(m_bits.capacity() * sizeof(uint64_t)), 0.0);
+}
+
+void AlphaMask::resize(int width, int height) {
+    memoryAdd(MEMORY_TEXTURES, -static_cast<double>(m_bits.capacity() * sizeof(uint64_t)), 0.0);
+    m_width = width;
+    m_height = height;
+    m_wordsPerRow = (width + 63) / 64;
+    std::vector<uint64_t>(static_cast<size_t>(m_wordsPerRow) * height, 0).swap(m_bits);
+    memoryAdd(MEMORY_TEXTURES, static_cast<double>(m_bits.capacity() * sizeof(uint64_t)), 0.0);
+}
+
+void AlphaMask::fillSolid(int width, int height) {
+    resize(width, height);
+    for (int y = 0; y < m_height; ++y) {
+        uint64_t* bits = row(y);
+        for (int x = 0; x < m_width; ++x) bits[x / 64] |= 1ULL << (x % 64);
+    }
+}
+
+bool AlphaMask::load(const char* path, int width, int height) {
+    int imageWidth, imageHeight, channels;
+    stbi_set_flip_vertically_on_load(true); // Bottom row first, like the textures and world y
+    unsigned char* data = stbi_load(path, &imageWidth, &imageHeight, &channels, 4); // Images without alpha come back opaque
+    if (data == nullptr) {
+        std::cerr << "Failed to load collision mask: " << path << " (using its bounding box)" << std::endl;
+        fillSolid(width, height);
+        return false;
+    }
+
+    resize(width, height);
+    // Each cell averages the block of texels it covers, the way the mipmapped texture looks at this size
+    for (int y = 0; y < m_height; ++y) {
+        int y0 = y * imageHeight / m_height;
+        int y1 = std::max(y0 + 1, (y + 1) * imageHeight / m_height);
+        uint64_t* bits = row(y);
+        for (int x = 0; x < m_width; ++x) {
+            int x0 = x * imageWidth / m_width;
+            int x1 = std::max(x0 + 1, (x + 1) * imageWidth / m_width);
+            long long alphaSum = 0;
+            for (int ty = y0; ty < y1; ++ty) {
+                const unsigned char* texel = data + (static_cast<size_t>(ty) * imageWidth + x0) * 4;
+                for (int tx = x0; tx < x1; ++tx, texel += 4) alphaSum += texel[3];
+            }
+            if (alphaSum >= static_cast<long long>(ALPHA_THRESHOLD) * (x1 - x0) * (y1 - y0)) {
+                bits[x / 64] |= 1ULL << (x % 64);
+            }
+        }
+    }
+    stbi_image_free(data);
+    std::cout << "Collision mask " << path << ": " << m_width << "x" << m_height << ", "
+        << setCount() << " opaque cells." << std::endl;
+    return true;
+}
+
+void AlphaMask::clipToEllipse() {
+    float rx = m_width / 2.0f;
+    float ry = m_height / 2.0f;
+    for (int y = 0; y < m_height; ++y) {
+        uint64_t* bits = row(y);
+        float ny = (y + 0.5f - ry) / ry;
+        for (int x = 0; x < m_width; ++x) {
+            float nx = (x + 0.5f - rx) / rx;
+            if (nx * nx + ny * ny > 1.0f) bits[x / 64] &= ~(1ULL << (x % 64));
+        }
+    }
+}
+
+int AlphaMask::overlapCount(const AlphaMask& other, int dx, int dy) const {
+    int xBegin = std::max(0, dx);
+    int xEnd = std::min(m_width, dx + other.m_width);
+    int yBegin = std::max(0, dy);
+    int yEnd = std::min(m_height, dy + other.m_height);
+    if (xBegin >= xEnd || yBegin >= yEnd) return 0;
+
+    // Only the words of this mask the other one reaches; the other's row is shifted into place per word
+    int firstWord = xBegin / 64;
+    int lastWord = (xEnd - 1) / 64;
+    int count = 0;
+    for (int y = yBegin; y < yEnd; ++y) {
+        const uint64_t* mine = row(y);
+        const uint64_t* theirs = other.row(y - dy);
+        for (int word = firstWord; word <= lastWord; ++word) {
+            count += popcount64(mine[word] & rowBitsAt(theirs, other.m_wordsPerRow, word * 64 - dx));
+        }
+    }
+    return count;
+}
+
+int AlphaMask::setCount() const {
+    int count = 0;
+    for (uint64_t bits : m_bits) count += popcount64(bits);
+    return count;
+}
@@ -0,0 +1,47 @@
+#ifndef ALPHA_MASK_H
+#define ALPHA_MASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Collision shape of a sprite: one bit per simulation unit (one world unit, which is one pixel at the
+// default window size), set where the sprite is opaque. Rows are packed into 64-bit words, bit 0 of
+// word 0 being the left edge, and row 0 is the bottom row like world y.
+//
+// Masks are built once when the game loads, at the size the sprite is drawn, and tested after the
+// AABB pass: one mask is shifted onto the other and the rows are ANDed a word at a time, so a test
+// costs a few dozen AND and popcount instructions instead of a loop over pixels.
+class AlphaMask {
+public:
+    AlphaMask();
+    ~AlphaMask();
+    AlphaMask(const AlphaMask&) = delete;
+    AlphaMask& operator=(const AlphaMask&) = delete;
+
+    // Samples the alpha channel of an image file at width x height cells. A cell is set when the texels
+    // it covers are at least half opaque on average. If the file can't be read the mask is left solid,
+    // so collisions fall back to the bounding box, and false is returned.
+    bool load(const char* path, int width, int height);
+    void fillSolid(int width, int height);
+    void clipToEllipse();       // Clears the cells outside the inscribed ellipse, for sprites drawn on the circle mesh
+
+    // Number of set cells the two masks share when the bottom-left corner of other sits at cell (dx, dy) of this mask
+    int overlapCount(const AlphaMask& other, int dx, int dy) const;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int setCount() const;       // Opaque cells in the whole mask
+
+private:
+    void resize(int width, int height);
+    const uint64_t* row(int y) const { return &m_bits[static_cast<size_t>(y) * m_wordsPerRow]; }
+    uint64_t* row(int y) { return &m_bits[static_cast<size_t>(y) * m_wordsPerRow]; }
+
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    std::vector<uint64_t> m_bits;   // m_height rows of m_wordsPerRow words, bits past m_width always clear
+};
+
+#endif // ALPHA_MASK_H
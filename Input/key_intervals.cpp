@@ -0,0 +1,36 @@
+#include "key_intervals.h" // Include the corresponding header file
+
+#include <algorithm>
+
+const double KeyIntervals::MIN_HOLD_SECONDS = 1.0 / 60.0;
+
+KeyIntervals::KeyIntervals() : m_down(false), m_pressTime(0.0), m_intervalStart(0.0), m_heldSeconds(0.0) {}
+
+void KeyIntervals::press(double time) {
+    if (m_down) return; // A press without a release in between (e.g. the window got focus back)
+    m_down = true;
+    m_pressTime = time;
+    m_intervalStart = time;
+}
+
+void KeyIntervals::release(double time) {
+    if (!m_down) return;
+    m_down = false;
+    m_heldSeconds += std::max(0.0, time - m_intervalStart);
+
+    // Holds shorter than a poll were cut short by the timestamps, not by the player
+    double holdSeconds = time - m_pressTime;
+    if (holdSeconds < MIN_HOLD_SECONDS) {
+        m_heldSeconds += MIN_HOLD_SECONDS - std::max(0.0, holdSeconds);
+    }
+}
+
+double KeyIntervals::takeHeldSeconds(double now) {
+    double held = m_heldSeconds;
+    if (m_down) {
+        held += std::max(0.0, now - m_intervalStart);
+        m_intervalStart = now;
+    }
+    m_heldSeconds = 0.0;
+    return held;
+}
@@ -0,0 +1,33 @@
+#ifndef KEY_INTERVALS_H
+#define KEY_INTERVALS_H
+
+// Press and release times of one key, turned into how long the key was held during each tick.
+// Movement keys go through this instead of glfwGetKey, so the basket moves for as long as the key
+// was really down rather than for every frame that happened to see it down, and a tap that starts
+// and ends between two polls still counts.
+//
+// GLFW events carry no timestamps, so times are taken when an event is handled: they are as precise
+// as the event polling (the main loop also polls while the frame limiter waits). Main thread only.
+class KeyIntervals {
+public:
+    // A tap pressed and released within one poll gets two equal timestamps. It counts as held this
+    // long, one poll at 60 Hz, which is what a tap moved the basket when sampling happened to catch it.
+    static const double MIN_HOLD_SECONDS;
+
+    KeyIntervals();
+
+    void press(double time);
+    void release(double time);
+
+    // Seconds the key was held since the previous call, up to 'now' if it is still down
+    double takeHeldSeconds(double now);
+    bool isDown() const { return m_down; }
+
+private:
+    bool m_down;
+    double m_pressTime;         // When the current hold started
+    double m_intervalStart;     // Start of the part of the current hold not taken yet
+    double m_heldSeconds;       // Finished holds (or parts of them) not taken yet
+};
+
+#endif // KEY_INTERVALS_H
@@ -0,0 +1,70 @@
+#include "frame_arena.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include "../Metrics/metrics.h"
+#include "../Profiler/alloc_tracker.h"
+#include "../Profiler/memory_report.h"
+
+static const size_t MAX_OVERFLOW_BLOCKS = 64; // Reserved up front, so recording an overflow doesn't allocate as well
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(static_cast<char*>(::operator new(capacity))), m_capacity(capacity), m_used(0), m_overflowBytes(0), m_highWater(0) {
+    m_overflow.reserve(MAX_OVERFLOW_BLOCKS);
+    memoryAdd(MEMORY_FRAME_ARENA, static_cast<double>(m_capacity + m_overflow.capacity() * sizeof(void*)), 0.0);
+}
+
+FrameArena::~FrameArena() {
+    for (void* block : m_overflow) ::operator delete(block);
+    ::operator delete(m_block);
+    memoryAdd(MEMORY_FRAME_ARENA, -static_cast<double>(m_capacity + m_overflow.capacity() * sizeof(void*)), 0.0);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    size_t offset = (m_used + alignment - 1) & ~(alignment - 1); // The block itself is aligned for any type
+    if (offset + bytes <= m_capacity) {
+        m_used = offset + bytes;
+        return m_block + offset;
+    }
+
+    metricAdd(METRIC_FRAME_ARENA_OVERFLOWS, 1);
+    void* block = ::operator new(bytes);
+    m_overflow.push_back(block);
+    m_overflowBytes += bytes;
+    return block;
+}
+
+void FrameArena::reset() {
+    size_t frameBytes = m_used + m_overflowBytes;
+    m_highWater = std::max(m_highWater, frameBytes);
+    metricSet(METRIC_FRAME_ARENA_BYTES, static_cast<double>(frameBytes));
+    metricMax(METRIC_FRAME_ARENA_HIGH_WATER, static_cast<double>(frameBytes));
+
+    for (void* block : m_overflow) ::operator delete(block);
+    m_overflow.clear();
+#ifndef NDEBUG
+    memset(m_block, 0xCD, m_used); // Anything still pointing in here reads garbage instead of last frame's values
+#endif
+    m_used = 0;
+    m_overflowBytes = 0;
+
+    // Grow to the next power of two that holds the biggest frame so far, once, instead of overflowing every frame
+    if (m_highWater > m_capacity) {
+        ALLOC_SCOPE("FrameArena::grow");
+        size_t capacity = m_capacity;
+        while (capacity < m_highWater) capacity *= 2;
+        ::operator delete(m_block);
+        m_block = static_cast<char*>(::operator new(capacity));
+        memoryAdd(MEMORY_FRAME_ARENA, static_cast<double>(capacity - m_capacity), 0.0);
+        std::cout << "Frame arena grown from " << m_capacity / 1024 << " KB to " << capacity / 1024 << " KB." << std::endl;
+        m_capacity = capacity;
+    }
+}
+
+FrameArena& frameArena() {
+    static FrameArena arena;
+    return arena;
+}
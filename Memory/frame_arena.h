@@ -0,0 +1,70 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Linear (bump) allocator for data that only lives until the end of the frame.
+// Allocating moves a pointer, freeing does nothing, and reset() at the top of every frame gives
+// all of it back at once. Main thread only.
+//
+// A frame that needs more than the block holds gets the rest from the heap (counted in
+// METRIC_FRAME_ARENA_OVERFLOWS), and the next reset() grows the block so later frames fit again.
+// Nothing allocated here may be kept past the frame: in debug builds reset() overwrites it with 0xCD.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+    void reset();               // Publishes the finished frame's usage, then frees everything
+
+    size_t used() const { return m_used; }
+    size_t capacity() const { return m_capacity; }
+    size_t highWater() const { return m_highWater; }
+
+private:
+    char* m_block;
+    size_t m_capacity;
+    size_t m_used;              // Bytes of the block handed out this frame, including alignment padding
+    size_t m_overflowBytes;     // Bytes that went to the heap this frame
+    size_t m_highWater;         // Most bytes (block and overflow) any frame needed
+    std::vector<void*> m_overflow; // Heap blocks to free at the next reset
+};
+
+FrameArena& frameArena();       // The main loop's arena, reset once per frame (and once per replayed tick)
+
+// STL allocator on top of a FrameArena, e.g. FrameVector<float> data{FrameAllocator<float>(frameArena())}.
+// deallocate() is a no-op, so a growing container leaves its old buffers behind until the reset:
+// reserve() what is known up front.
+template <typename T>
+class FrameAllocator {
+public:
+    typedef T value_type;
+
+    explicit FrameAllocator(FrameArena& arena) : m_arena(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : m_arena(other.arena()) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    FrameArena* arena() const { return m_arena; }
+
+private:
+    FrameArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena() == b.arena(); }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena() != b.arena(); }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+#endif // FRAME_ARENA_H
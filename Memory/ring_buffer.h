@@ -0,0 +1,121 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Growable FIFO on a circular buffer: append at the back, remove at the front, both O(1), and the
+// elements stay in insertion order. Index 0 is the front (the oldest element).
+// Unlike std::deque it keeps everything in one block, so iterating is a walk over contiguous memory
+// with one wrap. Elements only need to be movable; when the buffer is full it doubles and moves them
+// into the new block in order. Single-threaded (see AudioCommandQueue for the thread-safe, fixed-size kind).
+template <typename T>
+class RingBuffer {
+public:
+    // Forward iterator from the front to the back; Value is T or const T
+    template <typename Value>
+    class Iterator {
+    public:
+        Iterator(T* data, size_t capacity, size_t slot, size_t remaining)
+            : m_data(data), m_capacity(capacity), m_slot(slot), m_remaining(remaining) {}
+
+        Value& operator*() const { return m_data[m_slot]; }
+        Value* operator->() const { return m_data + m_slot; }
+        Iterator& operator++() {
+            if (++m_slot == m_capacity) m_slot = 0;
+            --m_remaining;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return m_remaining == other.m_remaining; }
+        bool operator!=(const Iterator& other) const { return m_remaining != other.m_remaining; }
+
+    private:
+        T* m_data;
+        size_t m_capacity;
+        size_t m_slot;          // Physical slot of the current element
+        size_t m_remaining;     // Elements left including the current one, 0 at the end
+    };
+    typedef Iterator<T> iterator;
+    typedef Iterator<const T> const_iterator;
+
+    RingBuffer() : m_data(nullptr), m_capacity(0), m_head(0), m_size(0) {}
+    ~RingBuffer() {
+        clear();
+        ::operator delete(m_data);
+    }
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (m_size == m_capacity) grow();
+        T* slot = m_data + wrap(m_head + m_size);
+        new (slot) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
+    }
+
+    void pop_front() {
+        m_data[m_head].~T();
+        m_head = wrap(m_head + 1);
+        --m_size;
+    }
+
+    // Removes the element at index by moving the ones in front of it back one slot, then popping the
+    // front. Costs O(index): cheap near the front, which is where a FIFO's stragglers usually are.
+    void erase(size_t index) {
+        for (size_t i = index; i > 0; --i) {
+            (*this)[i] = std::move((*this)[i - 1]);
+        }
+        pop_front();
+    }
+
+    void clear() {
+        while (m_size > 0) pop_front();
+        m_head = 0;
+    }
+
+    T& operator[](size_t index) { return m_data[wrap(m_head + index)]; }
+    const T& operator[](size_t index) const { return m_data[wrap(m_head + index)]; }
+    T& front() { return m_data[m_head]; }
+    const T& front() const { return m_data[m_head]; }
+    T& back() { return (*this)[m_size - 1]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    iterator begin() { return iterator(m_data, m_capacity, m_head, m_size); }
+    iterator end() { return iterator(m_data, m_capacity, m_head, 0); }
+    const_iterator begin() const { return const_iterator(m_data, m_capacity, m_head, m_size); }
+    const_iterator end() const { return const_iterator(m_data, m_capacity, m_head, 0); }
+
+private:
+    static const size_t INITIAL_CAPACITY = 16;
+
+    // Physical slot of a position up to twice the capacity past slot 0, without a division
+    size_t wrap(size_t position) const { return position >= m_capacity ? position - m_capacity : position; }
+
+    void grow() {
+        size_t capacity = m_capacity > 0 ? m_capacity * 2 : INITIAL_CAPACITY;
+        T* data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            T& element = (*this)[i];
+            new (data + i) T(std::move(element));
+            element.~T();
+        }
+        ::operator delete(m_data);
+        m_data = data;
+        m_capacity = capacity;
+        m_head = 0;
+    }
+
+    T* m_data;          // Raw storage for m_capacity elements, only the m_size from m_head on are constructed
+    size_t m_capacity;
+    size_t m_head;      // Slot of the front element
+    size_t m_size;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,75 @@
+#include "mesh_registry.h" // Include the corresponding header file
+
+#include <cstdio>
+#include <iostream>
+
+#include "primitive_meshes.h"
+#include "../Profiler/gl_debug.h"
+#include "../Profiler/gl_stats.h"
+#include "../Profiler/memory_report.h"
+
+static const char* g_meshNames[NUM_MESHES] = { "unit quad", "unit circle" };
+
+MeshRegistry::MeshRegistry() : m_meshes(), m_trackedGpuBytes(0.0) {}
+
+// Creates one VAO and VBO from a vertex table. The layout matches the game shader:
+// location 0 position, 1 normal, 2 texture coordinate.
+static Mesh uploadMesh(const char* name, GLenum mode, const float* vertices, GLsizei vertexCount) {
+    Mesh mesh;
+    mesh.mode = mode;
+    mesh.vertexCount = vertexCount;
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
+
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * MESH_FLOATS_PER_VERTEX * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    const GLsizei stride = MESH_FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    char label[64];
+    snprintf(label, sizeof(label), "mesh: %s VAO", name);
+    glDebugLabel(GL_VERTEX_ARRAY, mesh.VAO, label);
+    snprintf(label, sizeof(label), "mesh: %s VBO", name);
+    glDebugLabel(GL_BUFFER, mesh.VBO, label);
+    return mesh;
+}
+
+bool MeshRegistry::init() {
+    m_meshes[MESH_UNIT_QUAD] = uploadMesh(g_meshNames[MESH_UNIT_QUAD], GL_TRIANGLES, UNIT_QUAD_VERTICES.data, 6);
+    m_meshes[MESH_UNIT_CIRCLE] = uploadMesh(g_meshNames[MESH_UNIT_CIRCLE], GL_TRIANGLE_FAN, UNIT_CIRCLE_VERTICES.data,
+        CIRCLE_SEGMENTS + 2);
+
+    m_trackedGpuBytes = sizeof(UNIT_QUAD_VERTICES) + sizeof(UNIT_CIRCLE_VERTICES);
+    memoryAdd(MEMORY_MESHES, 0.0, m_trackedGpuBytes);
+
+    for (int i = 0; i < NUM_MESHES; ++i) {
+        if (m_meshes[i].VAO == 0 || m_meshes[i].VBO == 0) {
+            std::cerr << "Failed to create mesh: " << g_meshNames[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void MeshRegistry::release() {
+    for (Mesh& mesh : m_meshes) {
+        if (mesh.VBO != 0) glDeleteBuffers(1, &mesh.VBO);
+        if (mesh.VAO != 0) glDeleteVertexArrays(1, &mesh.VAO);
+        mesh = Mesh();
+    }
+    memoryAdd(MEMORY_MESHES, 0.0, -m_trackedGpuBytes);
+    m_trackedGpuBytes = 0.0;
+}
+
+MeshRegistry& meshRegistry() {
+    static MeshRegistry registry;
+    return registry;
+}
@@ -0,0 +1,37 @@
+#ifndef MESH_REGISTRY_H
+#define MESH_REGISTRY_H
+
+#include "../dependente/glew/glew.h"
+
+enum MeshID {
+    MESH_UNIT_QUAD = 0,     // Basket, HUD digits and messages
+    MESH_UNIT_CIRCLE,       // Orbs
+    NUM_MESHES
+};
+
+struct Mesh {
+    GLuint VAO;
+    GLuint VBO;
+    GLenum mode;            // Primitive type for glDrawArrays
+    GLsizei vertexCount;
+};
+
+// Shared, immutable GPU meshes, built from the compile-time tables in primitive_meshes.h.
+// Every game object draws one of these instead of owning its own VAO and VBO, so spawning
+// an orb no longer builds or uploads any geometry.
+class MeshRegistry {
+public:
+    MeshRegistry();
+
+    bool init();            // Uploads every mesh (needs a current GL context)
+    void release();         // Deletes the GL objects, before the context goes away
+    const Mesh& get(MeshID id) const { return m_meshes[id]; }
+
+private:
+    Mesh m_meshes[NUM_MESHES];
+    double m_trackedGpuBytes;   // What the meshes added to the memory report
+};
+
+MeshRegistry& meshRegistry();
+
+#endif // MESH_REGISTRY_H
@@ -0,0 +1,78 @@
+#ifndef PRIMITIVE_MESHES_H
+#define PRIMITIVE_MESHES_H
+
+#include <cstddef>
+
+// Vertex tables of the primitive meshes, generated at compile time. They end up in the executable's
+// read-only data, so once MeshRegistry has uploaded them there is no CPU copy on the heap at all.
+// Vertex layout shared by every game mesh: position (x,y,z), normal (x,y,z), texture coordinate (s,t).
+
+static const int MESH_FLOATS_PER_VERTEX = 8;
+
+template <size_t VertexCount>
+struct VertexTable {
+    float data[VertexCount * MESH_FLOATS_PER_VERTEX];
+};
+
+// sin/cos aren't constexpr, so the tables use a Taylor series after reducing the angle to [-pi, pi].
+// Twelve terms are accurate to about 1e-11 there, far below float precision.
+constexpr double MESH_PI = 3.14159265358979323846;
+
+constexpr double constexprSin(double x) {
+    while (x > MESH_PI) x -= 2.0 * MESH_PI;
+    while (x < -MESH_PI) x += 2.0 * MESH_PI;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constexprCos(double x) {
+    return constexprSin(x + MESH_PI / 2.0);
+}
+
+template <size_t VertexCount>
+constexpr void setVertex(VertexTable<VertexCount>& table, size_t index, float x, float y, float s, float t) {
+    float* v = table.data + index * MESH_FLOATS_PER_VERTEX;
+    v[0] = x;    v[1] = y;    v[2] = 0.0f; // Position
+    v[3] = 0.0f; v[4] = 0.0f; v[5] = 1.0f; // Normal, facing the camera
+    v[6] = s;    v[7] = t;                 // Texture coordinate
+}
+
+// Unit quad centred on the origin, two triangles (GL_TRIANGLES)
+constexpr VertexTable<6> makeUnitQuad() {
+    VertexTable<6> table{};
+    setVertex(table, 0, -0.5f, -0.5f, 0.0f, 0.0f); // bottom-left
+    setVertex(table, 1,  0.5f, -0.5f, 1.0f, 0.0f); // bottom-right
+    setVertex(table, 2,  0.5f,  0.5f, 1.0f, 1.0f); // top-right
+    setVertex(table, 3,  0.5f,  0.5f, 1.0f, 1.0f); // top-right
+    setVertex(table, 4, -0.5f,  0.5f, 0.0f, 1.0f); // top-left
+    setVertex(table, 5, -0.5f, -0.5f, 0.0f, 0.0f); // bottom-left
+    return table;
+}
+
+// Circle of radius 0.5 (it fits the unit quad) as a GL_TRIANGLE_FAN: the centre, then Segments + 1
+// points around the rim, the last one repeating the first to close the fan. Texture coordinates map
+// the circle onto the middle of the texture.
+template <int Segments>
+constexpr VertexTable<Segments + 2> makeUnitCircleFan() {
+    VertexTable<Segments + 2> table{};
+    setVertex(table, 0, 0.0f, 0.0f, 0.5f, 0.5f);
+    for (int i = 0; i <= Segments; ++i) {
+        double angle = 2.0 * MESH_PI * i / Segments;
+        float x = static_cast<float>(0.5 * constexprCos(angle));
+        float y = static_cast<float>(0.5 * constexprSin(angle));
+        setVertex(table, i + 1, x, y, x + 0.5f, y + 0.5f);
+    }
+    return table;
+}
+
+static const int CIRCLE_SEGMENTS = 30;
+
+constexpr VertexTable<6> UNIT_QUAD_VERTICES = makeUnitQuad();
+constexpr VertexTable<CIRCLE_SEGMENTS + 2> UNIT_CIRCLE_VERTICES = makeUnitCircleFan<CIRCLE_SEGMENTS>();
+
+#endif // PRIMITIVE_MESHES_H
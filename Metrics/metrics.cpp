@@ -0,0 +1,190 @@
+#include "metrics.h" // Include the corresponding header file
+
+#include <atomic>
+#include <cstdio>
+
+// Name, description and type of each metric, in the same order as MetricID
+struct MetricInfo {
+    const char* name;
+    const char* help;
+    MetricType type;
+};
+
+static const MetricInfo g_metricInfo[] = {
+    { "audio_callbacks",                "Audio data callbacks run",                                      MetricType::COUNTER },
+    { "audio_callback_ms",              "Duration of the last audio callback in ms",                     MetricType::GAUGE },
+    { "audio_callback_max_ms",          "Longest audio callback in ms",                                  MetricType::GAUGE },
+    { "audio_budget_ms",                "Time covered by one audio period in ms",                        MetricType::GAUGE },
+    { "audio_load",                     "Last audio callback duration divided by its budget",            MetricType::GAUGE },
+    { "audio_overruns",                 "Audio callbacks that took longer than their budget",            MetricType::COUNTER },
+    { "audio_xruns",                    "Audio callbacks that arrived too late (device starved)",        MetricType::COUNTER },
+    { "audio_music_underruns",          "Music reads the stream ring buffer couldn't satisfy",           MetricType::COUNTER },
+    { "audio_dropped_commands",         "Sound commands dropped because the queue was full",             MetricType::COUNTER },
+    { "cpu_pass_basket_ms",             "CPU submission time of the basket pass in ms",                  MetricType::GAUGE },
+    { "cpu_pass_orbs_ms",               "CPU submission time of the orbs pass in ms",                    MetricType::GAUGE },
+    { "cpu_pass_particles_earth_ms",    "CPU submission time of the earth particles pass in ms",         MetricType::GAUGE },
+    { "cpu_pass_particles_water_ms",    "CPU submission time of the water particles pass in ms",         MetricType::GAUGE },
+    { "cpu_pass_particles_fire_ms",     "CPU submission time of the fire particles pass in ms",          MetricType::GAUGE },
+    { "cpu_pass_particles_air_ms",      "CPU submission time of the air particles pass in ms",           MetricType::GAUGE },
+    { "cpu_pass_hud_ms",                "CPU submission time of the score HUD pass in ms",               MetricType::GAUGE },
+    { "cpu_pass_messages_ms",           "CPU submission time of the game over messages pass in ms",      MetricType::GAUGE },
+    { "gpu_pass_basket_ms",             "GPU time of the basket pass in ms",                             MetricType::GAUGE },
+    { "gpu_pass_orbs_ms",               "GPU time of the orbs pass in ms",                               MetricType::GAUGE },
+    { "gpu_pass_particles_earth_ms",    "GPU time of the earth particles pass in ms",                    MetricType::GAUGE },
+    { "gpu_pass_particles_water_ms",    "GPU time of the water particles pass in ms",                    MetricType::GAUGE },
+    { "gpu_pass_particles_fire_ms",     "GPU time of the fire particles pass in ms",                     MetricType::GAUGE },
+    { "gpu_pass_particles_air_ms",      "GPU time of the air particles pass in ms",                      MetricType::GAUGE },
+    { "gpu_pass_hud_ms",                "GPU time of the score HUD pass in ms",                          MetricType::GAUGE },
+    { "gpu_pass_messages_ms",           "GPU time of the game over messages pass in ms",                 MetricType::GAUGE },
+    { "gpu_queries_not_ready",          "GPU timer results dropped because they weren't ready in time",  MetricType::COUNTER },
+    { "frames",                         "Frames run",                                                    MetricType::COUNTER },
+    { "ticks",                          "Simulation ticks run",                                          MetricType::COUNTER },
+    { "frame_ms",                       "Wall time of the last frame in ms",                             MetricType::GAUGE },
+    { "frame_target_ms",                "Frame time expected from the limiter or vsync in ms",           MetricType::GAUGE },
+    { "frame_deadlines_missed",         "Frames that took more than 1.5 target frame times",             MetricType::COUNTER },
+    { "frame_limiter_wait_ms",          "Time the limiter held the last frame back in ms",               MetricType::GAUGE },
+    { "frame_limiter_late_ms",          "How late the limiter released the last frame in ms",            MetricType::GAUGE },
+    { "low_power_frames",               "Frames followed by a slow idle or background tick",             MetricType::COUNTER },
+    { "frames_skipped",                 "Frames not drawn because nothing visible changed",              MetricType::COUNTER },
+    { "cpu_update_ms",                  "CPU time of the last game update in ms",                        MetricType::GAUGE },
+    { "cpu_draw_ms",                    "CPU time of the last game draw in ms",                          MetricType::GAUGE },
+    { "draw_calls",                     "Draw calls issued in the last frame",                           MetricType::GAUGE },
+    { "draw_instances",                 "Instances drawn in the last frame",                             MetricType::GAUGE },
+    { "draw_vertices",                  "Vertices processed in the last frame, instances included",      MetricType::GAUGE },
+    { "gl_state_changes",               "GL binds, enables and uniform uploads in the last frame",       MetricType::GAUGE },
+    { "gl_redundant_state_changes",     "GL binds of an already bound object in the last frame",         MetricType::GAUGE },
+    { "gl_texture_binds",               "Texture binds in the last frame",                               MetricType::GAUGE },
+    { "gl_upload_bytes",                "Buffer bytes uploaded in the last frame",                       MetricType::GAUGE },
+    { "gl_budget_exceeded_frames",      "Frames over the draw call or upload budget",                    MetricType::COUNTER },
+    { "gl_performance_warnings",        "Performance warnings reported by the GL driver",                MetricType::COUNTER },
+    { "gl_debug_errors",                "Errors reported by the GL driver",                              MetricType::COUNTER },
+    { "draw_calls_basket",              "Draw calls of the basket pass in the last frame",               MetricType::GAUGE },
+    { "draw_calls_orbs",                "Draw calls of the orbs pass in the last frame",                 MetricType::GAUGE },
+    { "draw_calls_particles_earth",     "Draw calls of the earth particles pass in the last frame",      MetricType::GAUGE },
+    { "draw_calls_particles_water",     "Draw calls of the water particles pass in the last frame",      MetricType::GAUGE },
+    { "draw_calls_particles_fire",      "Draw calls of the fire particles pass in the last frame",       MetricType::GAUGE },
+    { "draw_calls_particles_air",       "Draw calls of the air particles pass in the last frame",        MetricType::GAUGE },
+    { "draw_calls_hud",                 "Draw calls of the score HUD pass in the last frame",            MetricType::GAUGE },
+    { "draw_calls_messages",            "Draw calls of the game over messages pass in the last frame",   MetricType::GAUGE },
+    { "draw_calls_other",               "Draw calls outside any render pass in the last frame",          MetricType::GAUGE },
+    { "process_rss_bytes",              "Resident memory of the process in bytes",                       MetricType::GAUGE },
+    { "frame_arena_bytes",              "Frame arena bytes the last frame used",                         MetricType::GAUGE },
+    { "frame_arena_high_water_bytes",   "Most frame arena bytes any frame used",                         MetricType::GAUGE },
+    { "frame_arena_overflows",          "Frame arena allocations that went to the heap",                 MetricType::COUNTER },
+    { "frame_allocs",                   "Heap allocations in the last frame",                            MetricType::GAUGE },
+    { "frame_alloc_bytes",              "Bytes allocated on the heap in the last frame",                 MetricType::GAUGE },
+    { "frame_frees",                    "Heap frees in the last frame",                                  MetricType::GAUGE },
+    { "steady_state_alloc_frames",      "Frames after warm-up that allocated outside an exempt scope",   MetricType::COUNTER },
+    { "live_orbs",                      "Orbs currently falling",                                        MetricType::GAUGE },
+    { "live_particles_earth",           "Active earth particles",                                        MetricType::GAUGE },
+    { "live_particles_water",           "Active water particles",                                        MetricType::GAUGE },
+    { "live_particles_fire",            "Active fire particles",                                         MetricType::GAUGE },
+    { "live_particles_air",             "Active air particles",                                          MetricType::GAUGE },
+    { "orbs_high_water",                "Most orbs alive at once",                                       MetricType::GAUGE },
+    { "particles_high_water_earth",     "Most earth particles alive at once",                            MetricType::GAUGE },
+    { "particles_high_water_water",     "Most water particles alive at once",                            MetricType::GAUGE },
+    { "particles_high_water_fire",      "Most fire particles alive at once",                             MetricType::GAUGE },
+    { "particles_high_water_air",       "Most air particles alive at once",                              MetricType::GAUGE },
+    { "collision_band_orbs",            "Orbs the last collision check tested",                          MetricType::GAUGE },
+    { "collision_mask_rejects",         "Box collisions the alpha masks ruled out",                      MetricType::COUNTER },
+    { "mem_cpu_textures_bytes",         "System memory held by textures",                                MetricType::GAUGE },
+    { "mem_cpu_particles_earth_bytes",  "System memory held by the earth particle pool",                 MetricType::GAUGE },
+    { "mem_cpu_particles_water_bytes",  "System memory held by the water particle pool",                 MetricType::GAUGE },
+    { "mem_cpu_particles_fire_bytes",   "System memory held by the fire particle pool",                  MetricType::GAUGE },
+    { "mem_cpu_particles_air_bytes",    "System memory held by the air particle pool",                   MetricType::GAUGE },
+    { "mem_cpu_orbs_bytes",             "System memory held by orbs",                                    MetricType::GAUGE },
+    { "mem_cpu_audio_bytes",            "System memory held by audio",                                   MetricType::GAUGE },
+    { "mem_cpu_shaders_bytes",          "System memory held by shader programs",                         MetricType::GAUGE },
+    { "mem_cpu_diagnostics_bytes",      "System memory held by profiling and logging buffers",           MetricType::GAUGE },
+    { "mem_cpu_frame_arena_bytes",      "System memory held by the per-frame arena",                     MetricType::GAUGE },
+    { "mem_cpu_meshes_bytes",           "System memory held by the shared meshes",                       MetricType::GAUGE },
+    { "mem_gpu_textures_bytes",         "Estimated video memory held by textures",                       MetricType::GAUGE },
+    { "mem_gpu_particles_earth_bytes",  "Estimated video memory held by the earth particle pool",        MetricType::GAUGE },
+    { "mem_gpu_particles_water_bytes",  "Estimated video memory held by the water particle pool",        MetricType::GAUGE },
+    { "mem_gpu_particles_fire_bytes",   "Estimated video memory held by the fire particle pool",         MetricType::GAUGE },
+    { "mem_gpu_particles_air_bytes",    "Estimated video memory held by the air particle pool",          MetricType::GAUGE },
+    { "mem_gpu_orbs_bytes",             "Estimated video memory held by orbs",                           MetricType::GAUGE },
+    { "mem_gpu_audio_bytes",            "Estimated video memory held by audio",                          MetricType::GAUGE },
+    { "mem_gpu_shaders_bytes",          "Estimated video memory held by shader programs",                MetricType::GAUGE },
+    { "mem_gpu_diagnostics_bytes",      "Estimated video memory held by profiling and logging buffers",  MetricType::GAUGE },
+    { "mem_gpu_frame_arena_bytes",      "Estimated video memory held by the per-frame arena",            MetricType::GAUGE },
+    { "mem_gpu_meshes_bytes",           "Estimated video memory held by the shared meshes",              MetricType::GAUGE },
+};
+static_assert(sizeof(g_metricInfo) / sizeof(g_metricInfo[0]) == NUM_METRICS, "g_metricInfo must have one entry per MetricID");
+
+static std::atomic<double> g_metricValues[NUM_METRICS];
+
+void metricSet(MetricID id, double value) {
+    g_metricValues[id].store(value, std::memory_order_relaxed);
+}
+
+// std::atomic<double> has no fetch_add before C++20, so use a compare-exchange loop
+void metricAdd(MetricID id, double amount) {
+    double current = g_metricValues[id].load(std::memory_order_relaxed);
+    while (!g_metricValues[id].compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {}
+}
+
+void metricMax(MetricID id, double value) {
+    double current = g_metricValues[id].load(std::memory_order_relaxed);
+    while (value > current && !g_metricValues[id].compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+double metricGet(MetricID id) {
+    return g_metricValues[id].load(std::memory_order_relaxed);
+}
+
+const char* metricName(MetricID id) { return g_metricInfo[id].name; }
+const char* metricHelp(MetricID id) { return g_metricInfo[id].help; }
+MetricType metricType(MetricID id) { return g_metricInfo[id].type; }
+
+void printMetrics(std::ostream& out) {
+    for (int i = 0; i < NUM_METRICS; ++i) {
+        out << g_metricInfo[i].name << " = " << g_metricValues[i].load(std::memory_order_relaxed) << std::endl;
+    }
+}
+
+// Upper bounds of the frame time buckets in ms: 240, 120, 60, 30, 20 and 10 FPS and slower
+static const double g_frameTimeBounds[] = { 4.167, 8.333, 16.667, 33.333, 50.0, 100.0 };
+static const int NUM_FRAME_TIME_BUCKETS = sizeof(g_frameTimeBounds) / sizeof(g_frameTimeBounds[0]);
+static std::atomic<uint64_t> g_frameTimeBuckets[NUM_FRAME_TIME_BUCKETS + 1]; // Last one is +Inf
+static std::atomic<double> g_frameTimeSum;
+
+void metricObserveFrameTime(double frameMs) {
+    int bucket = 0;
+    while (bucket < NUM_FRAME_TIME_BUCKETS && frameMs > g_frameTimeBounds[bucket]) bucket++;
+    g_frameTimeBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    double current = g_frameTimeSum.load(std::memory_order_relaxed);
+    while (!g_frameTimeSum.compare_exchange_weak(current, current + frameMs, std::memory_order_relaxed)) {}
+}
+
+// Names get a prefix, and counters the conventional _total suffix
+void writePrometheusMetrics(std::string& out) {
+    char line[256];
+    for (int i = 0; i < NUM_METRICS; ++i) {
+        const MetricInfo& info = g_metricInfo[i];
+        const char* suffix = info.type == MetricType::COUNTER ? "_total" : "";
+        const char* type = info.type == MetricType::COUNTER ? "counter" : "gauge";
+        snprintf(line, sizeof(line), "# HELP elemental_basket_%s%s %s\n# TYPE elemental_basket_%s%s %s\nelemental_basket_%s%s %.17g\n",
+            info.name, suffix, info.help, info.name, suffix, type, info.name, suffix,
+            g_metricValues[i].load(std::memory_order_relaxed));
+        out += line;
+    }
+
+    out += "# HELP elemental_basket_frame_time_ms Frame wall time in ms\n# TYPE elemental_basket_frame_time_ms histogram\n";
+    uint64_t cumulative = 0;
+    for (int i = 0; i <= NUM_FRAME_TIME_BUCKETS; ++i) {
+        cumulative += g_frameTimeBuckets[i].load(std::memory_order_relaxed);
+        if (i < NUM_FRAME_TIME_BUCKETS) {
+            snprintf(line, sizeof(line), "elemental_basket_frame_time_ms_bucket{le=\"%g\"} %llu\n",
+                g_frameTimeBounds[i], static_cast<unsigned long long>(cumulative));
+        }
+        else {
+            snprintf(line, sizeof(line), "elemental_basket_frame_time_ms_bucket{le=\"+Inf\"} %llu\n",
+                static_cast<unsigned long long>(cumulative));
+        }
+        out += line;
+    }
+    snprintf(line, sizeof(line), "elemental_basket_frame_time_ms_sum %.17g\nelemental_basket_frame_time_ms_count %llu\n",
+        g_frameTimeSum.load(std::memory_order_relaxed), static_cast<unsigned long long>(cumulative));
+    out += line;
+}
@@ -0,0 +1,146 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <ostream>
+#include <string>
+
+// Every performance value the game publishes.
+// Any thread may write a metric and any thread may read it: values are stored in
+// atomics, so publishing never takes a lock (the audio thread writes some of them).
+enum MetricID {
+    // Audio thread
+    METRIC_AUDIO_CALLBACKS = 0,     // Number of data callbacks run
+    METRIC_AUDIO_CALLBACK_MS,       // Duration of the last callback
+    METRIC_AUDIO_CALLBACK_MAX_MS,   // Longest callback so far
+    METRIC_AUDIO_BUDGET_MS,         // Time one period covers, the most a callback may take
+    METRIC_AUDIO_LOAD,              // Last callback duration / budget (1.0 means no headroom left)
+    METRIC_AUDIO_OVERRUNS,          // Callbacks that took longer than their budget
+    METRIC_AUDIO_XRUNS,             // Callbacks that arrived late enough that the device must have starved
+    METRIC_AUDIO_MUSIC_UNDERRUNS,   // Music reads the stream ring couldn't satisfy
+    METRIC_AUDIO_DROPPED_COMMANDS,  // Sound commands lost because the queue was full
+
+    // Render passes, in RenderPass order (see Profiler/gpu_timer.h)
+    METRIC_CPU_PASS_BASKET_MS,      // CPU time spent submitting the pass
+    METRIC_CPU_PASS_ORBS_MS,
+    METRIC_CPU_PASS_PARTICLES_EARTH_MS,
+    METRIC_CPU_PASS_PARTICLES_WATER_MS,
+    METRIC_CPU_PASS_PARTICLES_FIRE_MS,
+    METRIC_CPU_PASS_PARTICLES_AIR_MS,
+    METRIC_CPU_PASS_HUD_MS,
+    METRIC_CPU_PASS_MESSAGES_MS,
+    METRIC_GPU_PASS_BASKET_MS,      // GPU time the pass took, measured a few frames later
+    METRIC_GPU_PASS_ORBS_MS,
+    METRIC_GPU_PASS_PARTICLES_EARTH_MS,
+    METRIC_GPU_PASS_PARTICLES_WATER_MS,
+    METRIC_GPU_PASS_PARTICLES_FIRE_MS,
+    METRIC_GPU_PASS_PARTICLES_AIR_MS,
+    METRIC_GPU_PASS_HUD_MS,
+    METRIC_GPU_PASS_MESSAGES_MS,
+    METRIC_GPU_QUERIES_NOT_READY,   // Timer results still pending when their slot was reused (result dropped)
+
+    // Frame
+    METRIC_FRAMES,                  // Frames run so far
+    METRIC_TICKS,                   // Simulation ticks (Game::update calls) so far
+    METRIC_FRAME_MS,                // Wall time of the last frame
+    METRIC_FRAME_TARGET_MS,         // Frame time the pacer expects from the limiter or vsync, 0 if unknown (see Pacing/frame_pacer.h)
+    METRIC_FRAME_DEADLINES_MISSED,  // Frames that took more than 1.5 target frame times
+    METRIC_FRAME_LIMITER_WAIT_MS,   // Time the limiter held the last frame back
+    METRIC_FRAME_LIMITER_LATE_MS,   // How far past its deadline the limiter let the last frame go
+    METRIC_LOW_POWER_FRAMES,        // Frames followed by a slow tick (idle, unfocused or minimized)
+    METRIC_FRAMES_SKIPPED,          // Frames not drawn because they would look like the one on screen
+    METRIC_CPU_UPDATE_MS,           // Game::update of the last frame
+    METRIC_CPU_DRAW_MS,             // Game::draw of the last frame (all passes)
+    METRIC_DRAW_CALLS,              // Draw calls issued in the last frame (see Profiler/gl_stats.h)
+    METRIC_DRAW_INSTANCES,
+    METRIC_DRAW_VERTICES,
+    METRIC_GL_STATE_CHANGES,        // Binds, enables and uniform uploads
+    METRIC_GL_REDUNDANT_STATE_CHANGES, // Binds of what was already bound
+    METRIC_GL_TEXTURE_BINDS,
+    METRIC_GL_UPLOAD_BYTES,         // Buffer data uploaded
+    METRIC_GL_BUDGET_EXCEEDED_FRAMES, // Frames over the draw call or upload budget
+    METRIC_GL_PERFORMANCE_WARNINGS, // Driver performance messages (needs --gl-debug, see Profiler/gl_debug.h)
+    METRIC_GL_DEBUG_ERRORS,         // Driver error and undefined behavior messages
+    METRIC_DRAW_CALLS_BASKET,       // Draw calls per render pass, in RenderPass order, then everything else
+    METRIC_DRAW_CALLS_ORBS,
+    METRIC_DRAW_CALLS_PARTICLES_EARTH,
+    METRIC_DRAW_CALLS_PARTICLES_WATER,
+    METRIC_DRAW_CALLS_PARTICLES_FIRE,
+    METRIC_DRAW_CALLS_PARTICLES_AIR,
+    METRIC_DRAW_CALLS_HUD,
+    METRIC_DRAW_CALLS_MESSAGES,
+    METRIC_DRAW_CALLS_OTHER,
+    METRIC_PROCESS_RSS_BYTES,       // Resident memory of the process, sampled once per second while soak recording
+    METRIC_FRAME_ARENA_BYTES,       // Frame arena memory the last frame used (see Memory/frame_arena.h)
+    METRIC_FRAME_ARENA_HIGH_WATER,  // Most frame arena memory any frame used
+    METRIC_FRAME_ARENA_OVERFLOWS,   // Frame arena allocations that didn't fit and went to the heap
+    METRIC_FRAME_ALLOCS,            // Heap allocations in the last frame (only with TRACK_ALLOCATIONS)
+    METRIC_FRAME_ALLOC_BYTES,
+    METRIC_FRAME_FREES,
+    METRIC_STEADY_STATE_ALLOC_FRAMES, // Frames after warm-up that allocated outside an exempt scope
+
+    // Game state
+    METRIC_LIVE_ORBS,
+    METRIC_LIVE_PARTICLES_EARTH,    // Active particles per system, in ElementType order
+    METRIC_LIVE_PARTICLES_WATER,
+    METRIC_LIVE_PARTICLES_FIRE,
+    METRIC_LIVE_PARTICLES_AIR,
+    METRIC_ORBS_HIGH_WATER,         // Most orbs alive at once
+    METRIC_PARTICLES_HIGH_WATER_EARTH, // Most particles alive at once per pool, in ElementType order
+    METRIC_PARTICLES_HIGH_WATER_WATER,
+    METRIC_PARTICLES_HIGH_WATER_FIRE,
+    METRIC_PARTICLES_HIGH_WATER_AIR,
+    METRIC_COLLISION_BAND_ORBS,     // Orbs the last collision check tested, the band around the basket's height
+    METRIC_COLLISION_MASK_REJECTS,  // Orbs whose box touched the basket but whose alpha masks didn't (see Collision/alpha_mask.h)
+
+    // Memory per subsystem, in MemorySubsystem order (see Profiler/memory_report.h)
+    METRIC_MEM_CPU_TEXTURES,        // Bytes of system memory held
+    METRIC_MEM_CPU_PARTICLES_EARTH,
+    METRIC_MEM_CPU_PARTICLES_WATER,
+    METRIC_MEM_CPU_PARTICLES_FIRE,
+    METRIC_MEM_CPU_PARTICLES_AIR,
+    METRIC_MEM_CPU_ORBS,
+    METRIC_MEM_CPU_AUDIO,
+    METRIC_MEM_CPU_SHADERS,
+    METRIC_MEM_CPU_DIAGNOSTICS,
+    METRIC_MEM_CPU_FRAME_ARENA,
+    METRIC_MEM_CPU_MESHES,
+    METRIC_MEM_GPU_TEXTURES,        // Estimated bytes of video memory held
+    METRIC_MEM_GPU_PARTICLES_EARTH,
+    METRIC_MEM_GPU_PARTICLES_WATER,
+    METRIC_MEM_GPU_PARTICLES_FIRE,
+    METRIC_MEM_GPU_PARTICLES_AIR,
+    METRIC_MEM_GPU_ORBS,
+    METRIC_MEM_GPU_AUDIO,
+    METRIC_MEM_GPU_SHADERS,
+    METRIC_MEM_GPU_DIAGNOSTICS,
+    METRIC_MEM_GPU_FRAME_ARENA,
+    METRIC_MEM_GPU_MESHES,
+
+    NUM_METRICS
+};
+
+// Counters only ever go up, gauges hold the latest value
+enum class MetricType {
+    COUNTER,
+    GAUGE
+};
+
+void metricSet(MetricID id, double value);  // Overwrites the value (gauges)
+void metricAdd(MetricID id, double amount); // Adds to the value (counters)
+void metricMax(MetricID id, double value);  // Keeps the largest value seen
+double metricGet(MetricID id);
+
+const char* metricName(MetricID id);    // Short snake_case name, e.g. "audio_xruns"
+const char* metricHelp(MetricID id);    // One line description
+MetricType metricType(MetricID id);
+
+void printMetrics(std::ostream& out);   // Writes "name = value" for every metric
+
+// Frame time distribution, as cumulative buckets (lock-free like the metrics)
+void metricObserveFrameTime(double frameMs);
+
+// Appends every metric and the frame time histogram in the Prometheus text exposition format.
+// Each value is read atomically, so a scrape never blocks the threads that publish them.
+void writePrometheusMetrics(std::string& out);
+
+#endif // METRICS_H
@@ -0,0 +1,160 @@
+#include "metrics_server.h" // Include the corresponding header file
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "metrics.h"
+#include "../Profiler/alloc_tracker.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET SocketHandle;
+typedef int SocketLength;
+static void closeSocket(SocketHandle s) { closesocket(s); }
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int SocketHandle;
+typedef socklen_t SocketLength;
+static const SocketHandle INVALID_SOCKET = -1;
+static void closeSocket(SocketHandle s) { close(s); }
+#endif
+
+static const int ACCEPT_TIMEOUT_MS = 200;   // How often the server thread checks whether it should stop
+static const int RECEIVE_TIMEOUT_MS = 1000; // A client that sends nothing is dropped after this
+
+// On POSIX, writing to a socket the scraper already closed raises SIGPIPE, which kills the game.
+// Linux can turn that off per send; macOS only per socket (SO_NOSIGPIPE below); Windows has no SIGPIPE.
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+MetricsServer::MetricsServer() : m_listenSocket(static_cast<long long>(INVALID_SOCKET)), m_stopRequested(false) {}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(unsigned short port) {
+    if (isRunning()) return true;
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "Failed to initialize Winsock" << std::endl;
+        return false;
+    }
+#endif
+
+    SocketHandle listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket == INVALID_SOCKET) {
+        std::cerr << "Failed to create the metrics server socket" << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Never reachable from outside the machine
+    address.sin_port = htons(port);
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenSocket, 4) != 0) {
+        std::cerr << "Failed to listen on 127.0.0.1:" << port << " for metrics" << std::endl;
+        closeSocket(listenSocket);
+        return false;
+    }
+
+    m_listenSocket = static_cast<long long>(listenSocket);
+    m_stopRequested = false;
+    m_thread = std::thread(&MetricsServer::serve, this);
+    std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!isRunning()) return;
+    m_stopRequested = true;
+    m_thread.join();
+    closeSocket(static_cast<SocketHandle>(m_listenSocket));
+    m_listenSocket = static_cast<long long>(INVALID_SOCKET);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+// Clients are handled one at a time; a scrape takes well under a millisecond
+void MetricsServer::serve() {
+    ALLOC_SCOPE_EXEMPT("MetricsServer"); // Runs beside the game, its allocations aren't frame allocations
+    SocketHandle listenSocket = static_cast<SocketHandle>(m_listenSocket);
+    while (!m_stopRequested) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listenSocket, &readable);
+        timeval timeout = { 0, ACCEPT_TIMEOUT_MS * 1000 };
+        if (select(static_cast<int>(listenSocket) + 1, &readable, nullptr, nullptr, &timeout) <= 0) continue;
+
+        SocketHandle client = accept(listenSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        handleClient(static_cast<long long>(client));
+        closeSocket(client);
+    }
+}
+
+void MetricsServer::handleClient(long long clientHandle) {
+    SocketHandle client = static_cast<SocketHandle>(clientHandle);
+#ifdef _WIN32
+    DWORD receiveTimeout = RECEIVE_TIMEOUT_MS;
+#else
+    timeval receiveTimeout = { RECEIVE_TIMEOUT_MS / 1000, (RECEIVE_TIMEOUT_MS % 1000) * 1000 };
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+    // Only the request line matters, and it arrives in the first packet
+    char request[1024];
+    int received = recv(client, request, sizeof(request) - 1, 0);
+    if (received <= 0) return;
+    request[received] = '\0';
+
+    std::string body;
+    const char* status = "200 OK";
+    const char* contentType = "text/plain; version=0.0.4; charset=utf-8";
+    if (strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET / ", 6) == 0) {
+        body.reserve(16 * 1024);
+        writePrometheusMetrics(body);
+    }
+    else {
+        status = "404 Not Found";
+        contentType = "text/plain; charset=utf-8";
+        body = "Only GET /metrics is served\n";
+    }
+
+    char header[256];
+    int headerLength = snprintf(header, sizeof(header),
+        "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+        status, contentType, body.size());
+    std::string response(header, headerLength);
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int result = send(client, response.data() + sent, static_cast<int>(response.size() - sent), SEND_FLAGS);
+        if (result <= 0) return;
+        sent += result;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <thread>
+
+// Tiny HTTP server that answers GET /metrics with every metric in the Prometheus text format,
+// so a cabinet can be scraped or checked with "curl http://127.0.0.1:<port>/metrics".
+// It only binds to 127.0.0.1 and runs on its own thread; the game never waits for it,
+// because the metrics it reads are atomics.
+class MetricsServer {
+public:
+    MetricsServer();
+    ~MetricsServer();                               // Stops the server
+
+    bool start(unsigned short port);
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+private:
+    void serve();
+    void handleClient(long long client);
+
+    long long m_listenSocket;                       // SOCKET on Windows, file descriptor elsewhere
+    std::atomic<bool> m_stopRequested;
+    std::thread m_thread;
+};
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,179 @@
+#include "soak_recorder.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+#include "metrics.h"
+#include "../Profiler/alloc_tracker.h"
+#include "../Profiler/memory_report.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define PSAPI_VERSION 2 // GetProcessMemoryInfo from kernel32, no psapi.lib needed
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char* CSV_HEADER =
+    "time,uptime_s,frames,frame_ms_p50,frame_ms_p95,frame_ms_p99,frame_ms_max,update_ms_mean,update_ms_max,"
+    "live_orbs,live_particles,rss_bytes,texture_bytes,audio_music_underruns,audio_xruns,audio_dropped_commands\n";
+
+SoakRecorder::SoakRecorder()
+    : m_json(false), m_bufferedRows(0), m_fileBytes(0), m_frameCount(0), m_updateMsTotal(0.0), m_updateMsMax(0.0f) {}
+
+SoakRecorder::~SoakRecorder() {
+    flush();
+}
+
+// Starts a new file; a file left by a previous run is rotated away first, not appended to.
+bool SoakRecorder::open(const char* path) {
+    m_path = path;
+    size_t dot = m_path.find_last_of('.');
+    size_t slash = m_path.find_last_of("/\\");
+    bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    m_stem = hasExtension ? m_path.substr(0, dot) : m_path;
+    m_extension = hasExtension ? m_path.substr(dot) : "";
+    m_json = m_extension == ".json" || m_extension == ".jsonl";
+
+    std::ifstream existing(m_path);
+    if (existing.good()) {
+        existing.close();
+        rotate();
+    }
+
+    std::ofstream out(m_path, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open soak recording file: " << m_path << std::endl;
+        m_path.clear();
+        return false;
+    }
+    if (!m_json) {
+        out << CSV_HEADER;
+    }
+    m_fileBytes = m_json ? 0 : strlen(CSV_HEADER);
+
+    m_buffer.reserve(ROWS_PER_WRITE * 320); // A row is about 200 bytes, so filling the buffer never reallocates
+    memoryAdd(MEMORY_DIAGNOSTICS, static_cast<double>(m_buffer.capacity()), 0.0);
+    m_start = std::chrono::steady_clock::now();
+    m_sampleStart = m_start;
+    std::cout << "Recording soak metrics to " << m_path << std::endl;
+    return true;
+}
+
+void SoakRecorder::recordFrame(float frameMs, float updateMs) {
+    if (!isOpen()) return;
+
+    if (m_frameCount < MAX_FRAMES_PER_SAMPLE) {
+        m_frameMs[m_frameCount] = frameMs;
+    }
+    m_frameCount++;
+    m_updateMsTotal += updateMs;
+    m_updateMsMax = std::max(m_updateMsMax, updateMs);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_sampleStart >= std::chrono::seconds(static_cast<long long>(SAMPLE_SECONDS))) {
+        writeRow();
+        m_sampleStart = now;
+        m_frameCount = 0;
+        m_updateMsTotal = 0.0;
+        m_updateMsMax = 0.0f;
+    }
+}
+
+// Formats one row from this sample's frames and the current metric values
+void SoakRecorder::writeRow() {
+    int stored = std::min(m_frameCount, static_cast<int>(MAX_FRAMES_PER_SAMPLE));
+    std::sort(m_frameMs, m_frameMs + stored);
+    auto percentile = [&](double p) { return stored > 0 ? m_frameMs[std::min(stored - 1, static_cast<int>(stored * p))] : 0.0f; };
+
+    char timestamp[32];
+    std::time_t wallClock = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&wallClock));
+
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    double liveParticles = metricGet(METRIC_LIVE_PARTICLES_EARTH) + metricGet(METRIC_LIVE_PARTICLES_WATER)
+        + metricGet(METRIC_LIVE_PARTICLES_FIRE) + metricGet(METRIC_LIVE_PARTICLES_AIR);
+    uint64_t rss = processResidentBytes();
+    metricSet(METRIC_PROCESS_RSS_BYTES, static_cast<double>(rss));
+
+    const char* format = m_json
+        ? "{\"time\":\"%s\",\"uptime_s\":%.1f,\"frames\":%d,\"frame_ms_p50\":%.3f,\"frame_ms_p95\":%.3f,\"frame_ms_p99\":%.3f,"
+          "\"frame_ms_max\":%.3f,\"update_ms_mean\":%.3f,\"update_ms_max\":%.3f,\"live_orbs\":%.0f,\"live_particles\":%.0f,"
+          "\"rss_bytes\":%llu,\"texture_bytes\":%.0f,\"audio_music_underruns\":%.0f,\"audio_xruns\":%.0f,\"audio_dropped_commands\":%.0f}\n"
+        : "%s,%.1f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.0f,%.0f,%llu,%.0f,%.0f,%.0f,%.0f\n";
+
+    char row[512];
+    int length = snprintf(row, sizeof(row), format, timestamp, uptime, m_frameCount,
+        percentile(0.50), percentile(0.95), percentile(0.99), stored > 0 ? m_frameMs[stored - 1] : 0.0f,
+        m_frameCount > 0 ? m_updateMsTotal / m_frameCount : 0.0, m_updateMsMax,
+        metricGet(METRIC_LIVE_ORBS), liveParticles, static_cast<unsigned long long>(rss), memoryGpuBytes(MEMORY_TEXTURES),
+        metricGet(METRIC_AUDIO_MUSIC_UNDERRUNS), metricGet(METRIC_AUDIO_XRUNS), metricGet(METRIC_AUDIO_DROPPED_COMMANDS));
+    if (length <= 0) return;
+
+    m_buffer.append(row, std::min(length, static_cast<int>(sizeof(row)) - 1));
+    m_bufferedRows++;
+    if (m_bufferedRows >= ROWS_PER_WRITE) {
+        flush();
+    }
+}
+
+// Appends the buffered rows in one write. The file is only open during the write,
+// so nothing is lost if the cabinet is switched off between batches.
+void SoakRecorder::flush() {
+    if (!isOpen() || m_buffer.empty()) return;
+    ALLOC_SCOPE_EXEMPT("SoakRecorder::flush"); // File streams allocate, once per batch
+
+    if (m_fileBytes + m_buffer.size() > MAX_FILE_BYTES) {
+        rotate();
+        std::ofstream header(m_path, std::ios::trunc);
+        if (!m_json) header << CSV_HEADER;
+        m_fileBytes = m_json ? 0 : strlen(CSV_HEADER);
+    }
+
+    std::ofstream out(m_path, std::ios::app | std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write soak recording file: " << m_path << std::endl;
+        return; // Keep the rows, the next flush tries again
+    }
+    out.write(m_buffer.data(), m_buffer.size());
+    m_fileBytes += m_buffer.size();
+    m_buffer.clear();
+    m_bufferedRows = 0;
+}
+
+std::string SoakRecorder::rotatedPath(int index) const {
+    return m_stem + "." + std::to_string(index) + m_extension;
+}
+
+// soak.csv becomes soak.1.csv, soak.1.csv becomes soak.2.csv, and so on; the oldest is deleted
+void SoakRecorder::rotate() {
+    std::remove(rotatedPath(MAX_FILES - 1).c_str());
+    for (int i = MAX_FILES - 2; i >= 1; --i) {
+        std::rename(rotatedPath(i).c_str(), rotatedPath(i + 1).c_str());
+    }
+    std::rename(m_path.c_str(), rotatedPath(1).c_str());
+}
+
+uint64_t processResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    // Second field of /proc/self/statm is the resident size in pages
+    unsigned long long totalPages = 0, residentPages = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    int fields = fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+    fclose(statm);
+    return fields == 2 ? residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef SOAK_RECORDER_H
+#define SOAK_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Records a fixed set of metrics once per second for long (multi-day) runs, to find memory creep
+// and slowdowns after the fact. Rows are kept in memory and written in batches, and the file rotates
+// when it gets too big: soak.csv -> soak.1.csv -> soak.2.csv ..., the oldest is deleted.
+// A path ending in .json writes JSON Lines (one object per line, still readable if the process is killed).
+class SoakRecorder {
+public:
+    static const int SAMPLE_SECONDS = 1;
+    static const int ROWS_PER_WRITE = 30;              // Rows buffered before they go to disk
+    static const uint64_t MAX_FILE_BYTES = 8 * 1024 * 1024;
+    static const int MAX_FILES = 5;                    // Current file plus rotated ones
+    static const int MAX_FRAMES_PER_SAMPLE = 2048;     // Frames beyond this in one second are not included in percentiles
+
+    SoakRecorder();
+    ~SoakRecorder();                                    // Writes what is still buffered
+
+    bool open(const char* path);
+    bool isOpen() const { return !m_path.empty(); }
+    void recordFrame(float frameMs, float updateMs);    // Call once per frame; emits a row every SAMPLE_SECONDS
+    void flush();
+
+private:
+    void writeRow();
+    void rotate();
+    std::string rotatedPath(int index) const;
+
+    std::string m_path;         // Empty while not recording
+    std::string m_stem;         // m_path without the extension, for rotated names
+    std::string m_extension;
+    bool m_json;
+
+    std::string m_buffer;       // Rows not written yet
+    int m_bufferedRows;
+    uint64_t m_fileBytes;       // Size of the current file
+
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_sampleStart;
+    float m_frameMs[MAX_FRAMES_PER_SAMPLE];
+    int m_frameCount;           // Frames in the current sample, including any not stored in m_frameMs
+    double m_updateMsTotal;
+    float m_updateMsMax;
+};
+
+uint64_t processResidentBytes(); // Resident set size (working set on Windows), 0 if unknown
+
+#endif // SOAK_RECORDER_H
@@ -0,0 +1,267 @@
+#include "perf_overlay.h" // Include the corresponding header file
+
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+#include "../shader.hpp"
+#include "../Metrics/metrics.h"
+#include "../Profiler/gpu_timer.h"
+#include "../Profiler/gl_debug.h"
+#include "../Profiler/gl_stats.h"
+#include "../Profiler/memory_report.h"
+#include "../Profiler/alloc_tracker.h"
+#include "../Profiler/profiler.h"
+
+// Layout, in pixels
+static const float PANEL_X = 10.0f;
+static const float PANEL_Y = 10.0f;
+static const float PADDING = 8.0f;
+static const float GLYPH_PIXEL = 2.0f;                      // Size of one font pixel on screen
+static const float CHAR_ADVANCE = 4.0f * GLYPH_PIXEL;       // 3 pixels wide plus 1 of spacing
+static const float LINE_HEIGHT = 7.0f * GLYPH_PIXEL;        // 5 pixels high plus 2 of spacing
+static const float GRAPH_HEIGHT = 60.0f;
+static const float GRAPH_MAX_MS = 50.0f;                    // Frame time at the top of the graph
+static const int TEXT_LINES = 10 + NUM_RENDER_PASSES;
+static const int TEXT_COLUMNS = 40;                         // Longest line the panel fits, longer ones are cut
+static const int VERTICES_PER_RECT = 6;
+static const int MAX_GLYPH_PIXELS = 15;                     // Every pixel of a 3x5 glyph lit
+// Worst case of one frame: the panel, a bar per graph sample, the two budget lines and every character fully lit
+static const int MAX_VERTICES = (1 + PerfOverlay::GRAPH_SAMPLES + 2 + TEXT_LINES * TEXT_COLUMNS * MAX_GLYPH_PIXELS) * VERTICES_PER_RECT;
+
+// 3x5 pixel font. Each glyph is 5 rows of 3 bits, top row first, leftmost pixel in the highest bit.
+static const unsigned short g_digitGlyphs[10] = {
+    0b111'101'101'101'111, // 0
+    0b010'110'010'010'111, // 1
+    0b111'001'111'100'111, // 2
+    0b111'001'111'001'111, // 3
+    0b101'101'111'001'001, // 4
+    0b111'100'111'001'111, // 5
+    0b111'100'111'101'111, // 6
+    0b111'001'001'001'001, // 7
+    0b111'101'111'101'111, // 8
+    0b111'101'111'001'111, // 9
+};
+
+static const unsigned short g_letterGlyphs[26] = {
+    0b010'101'111'101'101, // A
+    0b110'101'110'101'110, // B
+    0b011'100'100'100'011, // C
+    0b110'101'101'101'110, // D
+    0b111'100'110'100'111, // E
+    0b111'100'110'100'100, // F
+    0b011'100'101'101'011, // G
+    0b101'101'111'101'101, // H
+    0b111'010'010'010'111, // I
+    0b001'001'001'101'010, // J
+    0b101'101'110'101'101, // K
+    0b100'100'100'100'111, // L
+    0b101'111'111'101'101, // M
+    0b110'101'101'101'101, // N
+    0b010'101'101'101'010, // O
+    0b110'101'110'100'100, // P
+    0b010'101'101'110'011, // Q
+    0b110'101'110'101'101, // R
+    0b011'100'010'001'110, // S
+    0b111'010'010'010'010, // T
+    0b101'101'101'101'111, // U
+    0b101'101'101'010'010, // V
+    0b101'101'111'111'101, // W
+    0b101'101'010'101'101, // X
+    0b101'101'010'010'010, // Y
+    0b111'001'010'100'111, // Z
+};
+
+static unsigned short glyphFor(char c) {
+    if (c >= '0' && c <= '9') return g_digitGlyphs[c - '0'];
+    if (c >= 'A' && c <= 'Z') return g_letterGlyphs[c - 'A'];
+    if (c >= 'a' && c <= 'z') return g_letterGlyphs[c - 'a']; // Upper case only
+    switch (c) {
+    case '.': return 0b000'000'000'000'010;
+    case ':': return 0b000'010'000'010'000;
+    case '-': return 0b000'000'111'000'000;
+    case '/': return 0b001'001'010'100'100;
+    default:  return 0; // Space and anything the font doesn't have
+    }
+}
+
+static const char* g_passLabels[NUM_RENDER_PASSES] = {
+    "BASKET", "ORBS", "EARTH", "WATER", "FIRE", "AIR", "HUD", "MESSAGES"
+};
+
+PerfOverlay::PerfOverlay()
+    : m_shaderProgram(0), m_VAO(0), m_VBO(0), m_screenSizeLoc(-1), m_bufferCapacity(0),
+    m_nextSample(0), m_visible(false), m_trackedCpuBytes(0.0), m_trackedGpuBytes(0.0) {
+    for (int i = 0; i < GRAPH_SAMPLES; ++i) {
+        m_frameMs[i] = 0.0f;
+    }
+}
+
+PerfOverlay::~PerfOverlay() {
+    memoryAdd(MEMORY_DIAGNOSTICS, -m_trackedCpuBytes, -m_trackedGpuBytes);
+    if (m_VBO != 0) glDeleteBuffers(1, &m_VBO);
+    if (m_VAO != 0) glDeleteVertexArrays(1, &m_VAO);
+    if (m_shaderProgram != 0) glDeleteProgram(m_shaderProgram);
+}
+
+bool PerfOverlay::init() {
+    m_shaderProgram = LoadShaders("OverlayVertexShader.vertexshader", "OverlayFragmentShader.fragmentshader");
+    if (m_shaderProgram == 0) {
+        std::cerr << "Failed to load overlay shaders, performance overlay disabled." << std::endl;
+        return false;
+    }
+    m_screenSizeLoc = glGetUniformLocation(m_shaderProgram, "screenSize");
+
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);                   // Position
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(float))); // Color
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glDebugLabel(GL_PROGRAM, m_shaderProgram, "overlay shader");
+    glDebugLabel(GL_VERTEX_ARRAY, m_VAO, "PerfOverlay VAO");
+    glDebugLabel(GL_BUFFER, m_VBO, "PerfOverlay VBO");
+
+    m_vertices.reserve(MAX_VERTICES); // Building a frame never allocates, even with every line full
+    trackMemory();
+    return true;
+}
+
+void PerfOverlay::trackMemory() {
+    double cpuBytes = sizeof(PerfOverlay) + m_vertices.capacity() * sizeof(Vertex);
+    double gpuBytes = m_bufferCapacity * sizeof(Vertex) + programBytes(m_shaderProgram);
+    memoryAdd(MEMORY_DIAGNOSTICS, cpuBytes - m_trackedCpuBytes, gpuBytes - m_trackedGpuBytes);
+    m_trackedCpuBytes = cpuBytes;
+    m_trackedGpuBytes = gpuBytes;
+}
+
+void PerfOverlay::recordFrame(float frameMs) {
+    m_frameMs[m_nextSample] = frameMs;
+    m_nextSample = (m_nextSample + 1) % GRAPH_SAMPLES;
+}
+
+void PerfOverlay::addRect(float x, float y, float width, float height, float r, float g, float b, float a) {
+    Vertex topLeft = { x, y, r, g, b, a };
+    Vertex topRight = { x + width, y, r, g, b, a };
+    Vertex bottomLeft = { x, y + height, r, g, b, a };
+    Vertex bottomRight = { x + width, y + height, r, g, b, a };
+    m_vertices.push_back(topLeft);
+    m_vertices.push_back(bottomLeft);
+    m_vertices.push_back(bottomRight);
+    m_vertices.push_back(bottomRight);
+    m_vertices.push_back(topRight);
+    m_vertices.push_back(topLeft);
+}
+
+// Every lit font pixel becomes a small quad
+float PerfOverlay::addText(float x, float y, const char* text, float r, float g, float b) {
+    for (const char* c = text; *c != '\0'; ++c) {
+        unsigned short glyph = glyphFor(*c);
+        for (int bit = 0; bit < 15; ++bit) {
+            if (glyph & (1 << (14 - bit))) {
+                int column = bit % 3;
+                int row = bit / 3;
+                addRect(x + column * GLYPH_PIXEL, y + row * GLYPH_PIXEL, GLYPH_PIXEL, GLYPH_PIXEL, r, g, b, 1.0f);
+            }
+        }
+        x += CHAR_ADVANCE;
+    }
+    return x;
+}
+
+void PerfOverlay::addLine(float& y, const char* format, ...) {
+    char line[TEXT_COLUMNS + 1]; // Text past the panel's edge is cut, which also keeps the vertex count within MAX_VERTICES
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    addText(PANEL_X + PADDING, y, line, 1.0f, 1.0f, 1.0f);
+    y += LINE_HEIGHT;
+}
+
+void PerfOverlay::draw(int screenWidth, int screenHeight) {
+    if (!m_visible || m_shaderProgram == 0) return;
+    PROFILE_SCOPE("PerfOverlay::draw");
+    ALLOC_SCOPE("PerfOverlay::draw");
+
+    m_vertices.clear();
+
+    float panelWidth = TEXT_COLUMNS * CHAR_ADVANCE + 2.0f * PADDING; // Wider than the graph
+    float panelHeight = GRAPH_HEIGHT + TEXT_LINES * LINE_HEIGHT + 3.0f * PADDING;
+    addRect(PANEL_X, PANEL_Y, panelWidth, panelHeight, 0.0f, 0.0f, 0.0f, 0.6f);
+
+    // Frame-time graph, oldest sample on the left. Bars are green within 60 FPS, yellow within 30 FPS, red beyond.
+    float graphX = PANEL_X + PADDING;
+    float graphBottom = PANEL_Y + PADDING + GRAPH_HEIGHT;
+    float pixelsPerMs = GRAPH_HEIGHT / GRAPH_MAX_MS;
+    float totalMs = 0.0f;
+    float maxMs = 0.0f;
+    for (int i = 0; i < GRAPH_SAMPLES; ++i) {
+        float ms = m_frameMs[(m_nextSample + i) % GRAPH_SAMPLES];
+        totalMs += ms;
+        if (ms > maxMs) maxMs = ms;
+
+        float barHeight = (ms < GRAPH_MAX_MS ? ms : GRAPH_MAX_MS) * pixelsPerMs;
+        if (ms <= 1000.0f / 60.0f)      addRect(graphX + i, graphBottom - barHeight, 1.0f, barHeight, 0.2f, 0.9f, 0.3f, 0.9f);
+        else if (ms <= 1000.0f / 30.0f) addRect(graphX + i, graphBottom - barHeight, 1.0f, barHeight, 1.0f, 0.8f, 0.1f, 0.9f);
+        else                            addRect(graphX + i, graphBottom - barHeight, 1.0f, barHeight, 1.0f, 0.2f, 0.2f, 0.9f);
+    }
+    // 60 and 30 FPS budget lines
+    addRect(graphX, graphBottom - (1000.0f / 60.0f) * pixelsPerMs, GRAPH_SAMPLES, 1.0f, 1.0f, 1.0f, 1.0f, 0.4f);
+    addRect(graphX, graphBottom - (1000.0f / 30.0f) * pixelsPerMs, GRAPH_SAMPLES, 1.0f, 1.0f, 1.0f, 1.0f, 0.4f);
+
+    float y = graphBottom + PADDING;
+    addLine(y, "FRAME %5.2f  AVG %5.2f  MAX %5.2f", metricGet(METRIC_FRAME_MS), totalMs / GRAPH_SAMPLES, maxMs);
+    addLine(y, "TARGET %5.2f  MISSED %d  WAIT %5.2f", metricGet(METRIC_FRAME_TARGET_MS),
+        static_cast<int>(metricGet(METRIC_FRAME_DEADLINES_MISSED)), metricGet(METRIC_FRAME_LIMITER_WAIT_MS));
+    addLine(y, "UPDATE %5.2f  DRAW %5.2f", metricGet(METRIC_CPU_UPDATE_MS), metricGet(METRIC_CPU_DRAW_MS));
+    addLine(y, "PASS       CPU MS  GPU MS  DRAWS");
+    for (int pass = 0; pass < NUM_RENDER_PASSES; ++pass) {
+        addLine(y, "%-9s  %6.3f  %6.3f  %5d", g_passLabels[pass],
+            metricGet(static_cast<MetricID>(METRIC_CPU_PASS_BASKET_MS + pass)),
+            metricGet(static_cast<MetricID>(METRIC_GPU_PASS_BASKET_MS + pass)),
+            static_cast<int>(metricGet(static_cast<MetricID>(METRIC_DRAW_CALLS_BASKET + pass))));
+    }
+    addLine(y, "ORBS %d  PARTICLES %d/%d/%d/%d", static_cast<int>(metricGet(METRIC_LIVE_ORBS)),
+        static_cast<int>(metricGet(METRIC_LIVE_PARTICLES_EARTH)), static_cast<int>(metricGet(METRIC_LIVE_PARTICLES_WATER)),
+        static_cast<int>(metricGet(METRIC_LIVE_PARTICLES_FIRE)), static_cast<int>(metricGet(METRIC_LIVE_PARTICLES_AIR)));
+    addLine(y, "DRAWS %d  INSTANCES %d  VERTICES %d", static_cast<int>(metricGet(METRIC_DRAW_CALLS)),
+        static_cast<int>(metricGet(METRIC_DRAW_INSTANCES)), static_cast<int>(metricGet(METRIC_DRAW_VERTICES)));
+    addLine(y, "STATE %d  REDUNDANT %d  TEX BINDS %d", static_cast<int>(metricGet(METRIC_GL_STATE_CHANGES)),
+        static_cast<int>(metricGet(METRIC_GL_REDUNDANT_STATE_CHANGES)), static_cast<int>(metricGet(METRIC_GL_TEXTURE_BINDS)));
+    addLine(y, "UPLOAD %.1f KB  TEXTURES %.0f KB", metricGet(METRIC_GL_UPLOAD_BYTES) / 1024.0,
+        memoryGpuBytes(MEMORY_TEXTURES) / 1024.0);
+    addLine(y, "MEM CPU %.1f MB  GPU %.1f MB", memoryTotalCpuBytes() / (1024.0 * 1024.0),
+        memoryTotalGpuBytes() / (1024.0 * 1024.0));
+    if (allocTrackerCompiledIn()) {
+        addLine(y, "ALLOCS %d  %d B  FREES %d", static_cast<int>(metricGet(METRIC_FRAME_ALLOCS)),
+            static_cast<int>(metricGet(METRIC_FRAME_ALLOC_BYTES)), static_cast<int>(metricGet(METRIC_FRAME_FREES)));
+    }
+    else {
+        addLine(y, "ALLOCS NOT TRACKED");
+    }
+
+    // Upload and draw everything at once. The buffer is orphaned each frame so the driver never waits
+    // for the previous frame's draw to finish reading it.
+    glDebugPushGroup("pass: overlay");
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    if (m_vertices.size() > m_bufferCapacity) {
+        m_bufferCapacity = m_vertices.capacity();
+        trackMemory();
+    }
+    glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(Vertex), m_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glUseProgram(m_shaderProgram);
+    glUniform2f(m_screenSizeLoc, static_cast<float>(screenWidth), static_cast<float>(screenHeight));
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
+    glBindVertexArray(0);
+    glDebugPopGroup();
+}
@@ -0,0 +1,50 @@
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <vector>
+
+#include "../dependente/glew/glew.h"
+
+// Performance overlay drawn on top of the game (toggled with F3).
+// Shows a rolling frame-time graph and the live values of the metrics surface:
+// CPU/GPU time per render pass, live orbs and particles, draw calls, texture memory and memory per subsystem.
+// Everything (panel, graph bars and text) is built into one vertex buffer of colored
+// triangles and submitted with a single draw call.
+class PerfOverlay {
+public:
+    static const int GRAPH_SAMPLES = 240; // Frames shown in the graph (4 seconds at 60 FPS)
+
+    PerfOverlay();
+    ~PerfOverlay();
+
+    bool init();                        // Loads the overlay shaders and creates the vertex buffer (needs a GL context)
+    void toggle() { m_visible = !m_visible; }
+    bool isVisible() const { return m_visible; }
+
+    void recordFrame(float frameMs);    // Adds one sample to the graph, also while hidden
+    void draw(int screenWidth, int screenHeight);
+
+private:
+    struct Vertex {
+        float x, y;         // Pixels, origin at the top-left corner of the window
+        float r, g, b, a;
+    };
+
+    void addRect(float x, float y, float width, float height, float r, float g, float b, float a);
+    float addText(float x, float y, const char* text, float r, float g, float b); // Returns the x after the last character
+    void addLine(float& y, const char* format, ...); // One line of white text, moves y to the next line
+    void trackMemory();                 // Brings the diagnostics row of the memory report up to date
+
+    GLuint m_shaderProgram;
+    GLuint m_VAO, m_VBO;
+    GLint m_screenSizeLoc;
+    size_t m_bufferCapacity;            // Vertices the VBO can hold before it has to grow
+
+    std::vector<Vertex> m_vertices;     // Rebuilt every frame, capacity is kept
+    float m_frameMs[GRAPH_SAMPLES];     // Ring of frame times
+    int m_nextSample;
+    bool m_visible;
+    double m_trackedCpuBytes, m_trackedGpuBytes; // What the overlay added to the memory report
+};
+
+#endif // PERF_OVERLAY_H
@@ -0,0 +1,164 @@
+#include "frame_pacer.h" // Include the corresponding header file
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+#include "../Metrics/metrics.h"
+#include "../Profiler/profiler.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib") // timeBeginPeriod
+#endif
+
+using PacerClock = std::chrono::steady_clock;
+
+static const double MAX_DELTA_SECONDS = 0.25;      // Longer frames (a stall, a window drag) are handed to the game as this
+static const double MISSED_DEADLINE_FACTOR = 1.5;  // A frame this many periods long missed its deadline
+static const double SNAP_TOLERANCE = 0.05;         // Smoothed delta within 5% of the period is taken as exactly one period
+static const double INITIAL_SLEEP_SECONDS = 0.002; // Guess for a 1 ms sleep until some have been measured
+static const int MAX_SLEEP_WEIGHT = 256;           // After this many sleeps, older ones fade out
+static const double SKIPPED_FRAME_SECONDS = 1.0 / 60.0; // Pace for skipped frames when neither vsync nor the limiter gives one
+
+FramePacer::FramePacer()
+    : m_limiterPeriod(0.0), m_period(0.0), m_smoothingFrames(1), m_timerPeriodSet(false), m_lowPower(false), m_frameSkipped(false),
+      m_started(false), m_hasDeadline(false), m_historyNext(0), m_historyCount(0), m_timeDebt(0.0),
+      m_rawFrameMs(0.0f), m_missedDeadlines(0),
+      m_sleepMean(INITIAL_SLEEP_SECONDS), m_sleepVariance(0.0), m_sleepCount(0) {}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if (m_timerPeriodSet) timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::configure(double targetFps, int refreshHz, int swapInterval, int smoothingFrames) {
+    m_limiterPeriod = targetFps > 0.0 ? 1.0 / targetFps : 0.0;
+    double vsyncPeriod = (refreshHz > 0 && swapInterval != 0) ? std::abs(swapInterval) / static_cast<double>(refreshHz) : 0.0;
+    m_period = std::max(m_limiterPeriod, vsyncPeriod); // A limiter faster than vsync can't make frames come sooner
+    m_smoothingFrames = std::min(std::max(smoothingFrames, 1), static_cast<int>(MAX_SMOOTHING_FRAMES));
+    m_historyNext = 0;
+    m_historyCount = 0;
+    m_timeDebt = 0.0;
+    m_hasDeadline = false;
+    metricSet(METRIC_FRAME_TARGET_MS, m_period * 1000.0);
+
+#ifdef _WIN32
+    // The default 15.6 ms timer tick makes every sleep far too coarse for the limiter
+    if (m_limiterPeriod > 0.0 && !m_timerPeriodSet) {
+        m_timerPeriodSet = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+#endif
+}
+
+float FramePacer::beginFrame() {
+    PacerClock::time_point now = PacerClock::now();
+    m_frameSkipped = false; // Set again if this frame turns out to have nothing new
+    if (!m_started) {
+        m_started = true;
+        m_frameStart = now;
+        return 0.0f; // Nothing to measure yet
+    }
+
+    double raw = std::chrono::duration<double>(now - m_frameStart).count();
+    m_frameStart = now;
+    m_rawFrameMs = static_cast<float>(raw * 1000.0);
+    if (!m_lowPower && m_period > 0.0 && raw > m_period * MISSED_DEADLINE_FACTOR) {
+        m_missedDeadlines++;
+        metricAdd(METRIC_FRAME_DEADLINES_MISSED, 1);
+    }
+
+    // Average the last few frames so one late wake-up doesn't make the orbs jump
+    double clamped = std::min(raw, MAX_DELTA_SECONDS);
+    m_history[m_historyNext] = static_cast<float>(clamped);
+    m_historyNext = (m_historyNext + 1) % m_smoothingFrames;
+    m_historyCount = std::min(m_historyCount + 1, m_smoothingFrames);
+    double sum = 0.0;
+    for (int i = 0; i < m_historyCount; ++i) sum += m_history[i];
+    double delta = sum / m_historyCount;
+
+    // Paced frames are shown a whole period apart, so the scatter around it is noise. Snap to the period
+    // unless that would let game time drift more than half a period from the measured time.
+    if (!m_lowPower && m_period > 0.0 && std::fabs(delta - m_period) < m_period * SNAP_TOLERANCE
+        && std::fabs(m_timeDebt + clamped - m_period) < m_period * 0.5) {
+        delta = m_period;
+    }
+    m_timeDebt += clamped - delta;
+    return static_cast<float>(delta);
+}
+
+// Slow ticks are several periods long, so frame times from before the switch would only skew the average
+void FramePacer::setLowPower(bool lowPower) {
+    if (lowPower == m_lowPower) return;
+    m_lowPower = lowPower;
+    m_historyNext = 0;
+    m_historyCount = 0;
+    m_timeDebt = 0.0;
+    m_hasDeadline = false;
+}
+
+double FramePacer::sleepEstimate() const {
+    return m_sleepMean + std::sqrt(m_sleepVariance);
+}
+
+// Deadlines are a fixed period apart, so a frame that starts a bit late is followed by a shorter wait
+// and the average rate stays on target. A frame more than a period late drops the backlog instead of
+// rushing the next frames to catch up.
+void FramePacer::waitForDeadline(void (*pollEvents)()) {
+    double periodSeconds = m_limiterPeriod;
+    if (m_frameSkipped) {
+        m_frameSkipped = false;
+        if (periodSeconds <= 0.0) {
+            // Only this frame is held, from its own start; the next swapped frame is paced by vsync again
+            periodSeconds = m_period > 0.0 ? m_period : SKIPPED_FRAME_SECONDS;
+            m_hasDeadline = false;
+        }
+    }
+    if (periodSeconds <= 0.0) return;
+    PROFILE_SCOPE("FramePacer::waitForDeadline");
+
+    PacerClock::duration period = std::chrono::duration_cast<PacerClock::duration>(std::chrono::duration<double>(periodSeconds));
+    if (!m_hasDeadline) {
+        m_deadline = m_frameStart;
+        m_hasDeadline = true;
+    }
+    m_deadline += period;
+
+    PacerClock::time_point now = PacerClock::now();
+    if (now >= m_deadline) {
+        if (now - m_deadline > period) m_deadline = now;
+        metricSet(METRIC_FRAME_LIMITER_WAIT_MS, 0.0);
+        metricSet(METRIC_FRAME_LIMITER_LATE_MS, 0.0);
+        return;
+    }
+
+    // Sleep while even a long sleep would wake up in time, then spin for the rest
+    PacerClock::time_point waitStart = now;
+    while (std::chrono::duration<double>(m_deadline - now).count() > sleepEstimate()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        PacerClock::time_point woke = PacerClock::now();
+        double slept = std::chrono::duration<double>(woke - now).count();
+        now = woke;
+
+        if (m_sleepCount < MAX_SLEEP_WEIGHT) m_sleepCount++;
+        double weight = 1.0 / m_sleepCount;
+        double difference = slept - m_sleepMean;
+        m_sleepMean += weight * difference;
+        m_sleepVariance = (1.0 - weight) * (m_sleepVariance + weight * difference * difference);
+
+        if (pollEvents != nullptr) {
+            pollEvents();
+            now = PacerClock::now(); // Polling takes time too, the next sleep decision must see it
+        }
+    }
+    while (now < m_deadline) {
+        now = PacerClock::now();
+    }
+
+    metricSet(METRIC_FRAME_LIMITER_WAIT_MS, std::chrono::duration<double, std::milli>(now - waitStart).count());
+    metricSet(METRIC_FRAME_LIMITER_LATE_MS, std::chrono::duration<double, std::milli>(now - m_deadline).count());
+}
@@ -0,0 +1,71 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+
+// Paces the main loop: measures each frame, hands the game a smoothed delta time, and optionally
+// holds frames back to a target rate with a hybrid limiter (sleeps while the deadline is far away,
+// spins for the last stretch because sleeps overshoot). A frame that takes more than 1.5 target
+// periods counts as a missed deadline. The swap interval itself is set by the caller with glfwSwapInterval.
+//
+// Per frame: beginFrame() at the top of the loop, waitForDeadline() after the buffer swap (or skipFrame()
+// and waitForDeadline() when there was nothing new to swap).
+class FramePacer {
+public:
+    static const int MAX_SMOOTHING_FRAMES = 16;
+
+    FramePacer();
+    ~FramePacer();
+
+    // targetFps 0 turns the limiter off. refreshHz and swapInterval give the expected frame period
+    // when only vsync paces the loop (refreshHz 0 = unknown). smoothingFrames 1 turns smoothing off.
+    void configure(double targetFps, int refreshHz, int swapInterval, int smoothingFrames);
+
+    float beginFrame();         // Returns the delta time for this frame, in seconds
+    // Does nothing while the limiter is off. pollEvents, if given, runs after every sleep, so events
+    // handled during a long wait are timestamped close to when they arrived instead of after it.
+    void waitForDeadline(void (*pollEvents)() = nullptr);
+
+    // The frame was not swapped, so vsync won't hold the loop back: the next waitForDeadline holds it
+    // to the expected period instead, even with the limiter off.
+    void skipFrame() { m_frameSkipped = true; }
+
+    // While the loop runs slow ticks of its own (idle or in the background), frames aren't held to
+    // the target and don't count as missed. Switching either way starts the smoothing over.
+    void setLowPower(bool lowPower);
+
+    float rawFrameMs() const { return m_rawFrameMs; }   // Measured time since the previous frame started
+    double periodMs() const { return m_period * 1000.0; } // Expected frame time, 0 if unknown
+    uint64_t missedDeadlines() const { return m_missedDeadlines; }
+
+private:
+    double sleepEstimate() const; // How long a 1 ms sleep can be expected to take, in seconds
+
+    double m_limiterPeriod;     // Seconds per frame the limiter holds to, 0 = off
+    double m_period;            // Expected seconds per frame from the limiter or vsync, 0 = unknown
+    int m_smoothingFrames;
+    bool m_timerPeriodSet;      // Windows timer resolution raised for the limiter
+    bool m_lowPower;
+    bool m_frameSkipped;        // No swap this frame
+
+    std::chrono::steady_clock::time_point m_frameStart;
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_started;
+    bool m_hasDeadline;
+
+    float m_history[MAX_SMOOTHING_FRAMES]; // Recent clamped frame times, a ring
+    int m_historyNext;
+    int m_historyCount;
+    double m_timeDebt;          // Measured time not yet handed to the game (negative: handed out ahead)
+    float m_rawFrameMs;
+    uint64_t m_missedDeadlines;
+
+    // Mean and variance of how long 1 ms sleeps really take, weighted towards recent ones,
+    // to know when to stop sleeping and spin
+    double m_sleepMean;
+    double m_sleepVariance;
+    int m_sleepCount;
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,183 @@
+#include "alloc_tracker.h" // Include the corresponding header file
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "../Metrics/metrics.h"
+
+#ifdef TRACK_ALLOCATIONS
+
+// Counts of one tag. Everything here is constant-initialized, because operator new
+// can run before any dynamic initializer (and from any thread).
+struct AllocTag {
+    std::atomic<const char*> name;
+    std::atomic<bool> exempt;
+    std::atomic<uint64_t> frameAllocs;  // Since the last allocTrackerNextFrame
+    std::atomic<uint64_t> frameBytes;
+    std::atomic<uint64_t> totalAllocs;  // Whole run
+    std::atomic<uint64_t> totalBytes;
+};
+
+static const int MAX_ALLOC_TAGS = 64;
+static const int UNTAGGED = 0;          // Allocations outside any ALLOC_SCOPE
+static const int TRACKER_TAG = 1;       // The tracker's own logging, always exempt
+
+static AllocTag g_allocTags[MAX_ALLOC_TAGS];
+static std::atomic<int> g_allocTagCount(2);
+static std::atomic<uint64_t> g_frameFrees(0);
+static thread_local int t_allocTag = UNTAGGED;
+
+static uint32_t g_allocFrame = 0;
+static bool g_steadyStateCheck = false;
+static uint32_t g_failedFrames = 0;
+static const uint32_t MAX_LOGGED_FAILURES = 10; // Enough to find the culprit without flooding the console
+
+static void recordAllocation(size_t size) {
+    AllocTag& tag = g_allocTags[t_allocTag];
+    tag.frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    tag.frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static const char* tagName(int index) {
+    if (index == UNTAGGED) return "untagged";
+    if (index == TRACKER_TAG) return "alloc tracker";
+    const char* name = g_allocTags[index].name.load(std::memory_order_acquire);
+    return name != nullptr ? name : "?";
+}
+
+static bool tagExempt(int index) {
+    return index == TRACKER_TAG || g_allocTags[index].exempt.load(std::memory_order_relaxed);
+}
+
+bool allocTrackerCompiledIn() { return true; }
+
+int allocTrackerRegisterTag(const char* name, bool exempt) {
+    int index = g_allocTagCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= MAX_ALLOC_TAGS) {
+        return UNTAGGED; // Table full, still counted, just not attributed
+    }
+    g_allocTags[index].exempt.store(exempt, std::memory_order_relaxed);
+    g_allocTags[index].name.store(name, std::memory_order_release);
+    return index;
+}
+
+AllocScope::AllocScope(int tag) : m_previousTag(t_allocTag) { t_allocTag = tag; }
+AllocScope::~AllocScope() { t_allocTag = m_previousTag; }
+
+void allocTrackerNextFrame() {
+    int previousTag = t_allocTag;
+    t_allocTag = TRACKER_TAG;
+
+    uint64_t frameAllocs = 0;
+    uint64_t frameBytes = 0;
+    uint64_t steadyStateAllocs = 0; // Allocations that count against the steady-state check
+    int tagCount = g_allocTagCount.load(std::memory_order_relaxed);
+    if (tagCount > MAX_ALLOC_TAGS) tagCount = MAX_ALLOC_TAGS;
+
+    // Frame counts are swapped out tag by tag; an allocation racing with this lands in the next frame
+    uint64_t tagAllocs[MAX_ALLOC_TAGS];
+    for (int i = 0; i < tagCount; ++i) {
+        AllocTag& tag = g_allocTags[i];
+        tagAllocs[i] = tag.frameAllocs.exchange(0, std::memory_order_relaxed);
+        uint64_t bytes = tag.frameBytes.exchange(0, std::memory_order_relaxed);
+        tag.totalAllocs.fetch_add(tagAllocs[i], std::memory_order_relaxed);
+        tag.totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        frameAllocs += tagAllocs[i];
+        frameBytes += bytes;
+        if (!tagExempt(i)) steadyStateAllocs += tagAllocs[i];
+    }
+
+    metricSet(METRIC_FRAME_ALLOCS, static_cast<double>(frameAllocs));
+    metricSet(METRIC_FRAME_ALLOC_BYTES, static_cast<double>(frameBytes));
+    metricSet(METRIC_FRAME_FREES, static_cast<double>(g_frameFrees.exchange(0, std::memory_order_relaxed)));
+
+    if (g_steadyStateCheck && g_allocFrame >= ALLOC_WARMUP_FRAMES && steadyStateAllocs > 0) {
+        g_failedFrames++;
+        metricAdd(METRIC_STEADY_STATE_ALLOC_FRAMES, 1);
+        if (g_failedFrames <= MAX_LOGGED_FAILURES) {
+            std::cerr << "Allocation check: frame " << g_allocFrame << " allocated " << steadyStateAllocs << " time(s) in steady state:";
+            for (int i = 0; i < tagCount; ++i) {
+                if (tagAllocs[i] > 0 && !tagExempt(i)) {
+                    std::cerr << " " << tagName(i) << " x" << tagAllocs[i];
+                }
+            }
+            std::cerr << std::endl;
+        }
+    }
+    g_allocFrame++;
+
+    t_allocTag = previousTag;
+}
+
+void allocTrackerSetSteadyStateCheck(bool enabled) { g_steadyStateCheck = enabled; }
+bool allocTrackerCheckFailed() { return g_failedFrames > 0; }
+
+void allocTrackerReport(std::ostream& out) {
+    int previousTag = t_allocTag;
+    t_allocTag = TRACKER_TAG;
+
+    int tagCount = g_allocTagCount.load(std::memory_order_relaxed);
+    if (tagCount > MAX_ALLOC_TAGS) tagCount = MAX_ALLOC_TAGS;
+    for (int i = 0; i < tagCount; ++i) {
+        uint64_t allocs = g_allocTags[i].totalAllocs.load(std::memory_order_relaxed);
+        if (allocs == 0) continue;
+        out << tagName(i) << ": " << allocs << " allocations, "
+            << g_allocTags[i].totalBytes.load(std::memory_order_relaxed) << " bytes"
+            << (tagExempt(i) ? " (exempt)" : "") << std::endl;
+    }
+    if (g_steadyStateCheck) {
+        out << "Steady-state frames that allocated: " << g_failedFrames << std::endl;
+    }
+
+    t_allocTag = previousTag;
+}
+
+// Replacement global allocation functions. They only touch atomics and thread_locals,
+// so they are safe on the audio thread and before main.
+void* operator new(std::size_t size) {
+    recordAllocation(size);
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    recordAllocation(size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory == nullptr) return;
+    g_frameFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept { operator delete(memory); }
+void operator delete(void* memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { operator delete(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { operator delete(memory); }
+
+#else // TRACK_ALLOCATIONS
+
+bool allocTrackerCompiledIn() { return false; }
+int allocTrackerRegisterTag(const char* name, bool exempt) { return 0; }
+AllocScope::AllocScope(int tag) : m_previousTag(0) {}
+AllocScope::~AllocScope() {}
+void allocTrackerNextFrame() {}
+void allocTrackerSetSteadyStateCheck(bool enabled) {}
+bool allocTrackerCheckFailed() { return false; }
+void allocTrackerReport(std::ostream& out) {}
+
+#endif // TRACK_ALLOCATIONS
@@ -0,0 +1,52 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Heap allocation tracker.
+// Define TRACK_ALLOCATIONS to replace the global operator new/delete with versions that count
+// allocations and bytes per frame and per tagged scope. Without it every call below is a cheap stub
+// and ALLOC_SCOPE compiles out, so the hook costs nothing in normal builds.
+//
+// Steady-state check: after ALLOC_WARMUP_FRAMES, every frame that allocates outside an exempt
+// scope is a failure. The main loop enables it with --alloc-check and exits with an error code.
+
+static const uint32_t ALLOC_WARMUP_FRAMES = 120; // Loading, first spawns and buffer growth happen before this
+
+bool allocTrackerCompiledIn();              // Whether this build has the new/delete hook
+void allocTrackerNextFrame();               // Call once per frame, closes the previous frame's counts
+void allocTrackerSetSteadyStateCheck(bool enabled);
+bool allocTrackerCheckFailed();             // A steady-state frame allocated since the check was enabled
+void allocTrackerReport(std::ostream& out); // Totals per tag
+
+// Tags are registered once per call site. Exempt tags are counted but never fail the steady-state check,
+// for allocations that are known and accepted (e.g. a new orb every spawn interval).
+int allocTrackerRegisterTag(const char* name, bool exempt);
+
+// Attributes the allocations of the calling thread to a tag for the lifetime of the scope
+class AllocScope {
+public:
+    explicit AllocScope(int tag);
+    ~AllocScope();
+
+private:
+    int m_previousTag;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#ifdef TRACK_ALLOCATIONS
+#define ALLOC_SCOPE_IMPL(name, exempt) \
+    static const int ALLOC_CONCAT(allocTag_, __LINE__) = allocTrackerRegisterTag(name, exempt); \
+    AllocScope ALLOC_CONCAT(allocScope_, __LINE__)(ALLOC_CONCAT(allocTag_, __LINE__))
+#define ALLOC_SCOPE(name) ALLOC_SCOPE_IMPL(name, false)
+#define ALLOC_SCOPE_EXEMPT(name) ALLOC_SCOPE_IMPL(name, true)
+#else
+#define ALLOC_SCOPE(name) ((void)0)
+#define ALLOC_SCOPE_EXEMPT(name) ((void)0)
+#endif
+
+#endif // ALLOC_TRACKER_H
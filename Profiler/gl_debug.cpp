@@ -0,0 +1,110 @@
+#include "gl_debug.h" // Include the corresponding header file
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "../dependente/glfw/glfw3.h"
+#include "profiler.h"
+#include "../Metrics/metrics.h"
+
+// The bundled GLEW declares glPushDebugGroup but not glPopDebugGroup, so it is looked up here
+typedef void (GLAPIENTRY * PopDebugGroupProc)(void);
+static PopDebugGroupProc g_popDebugGroup = nullptr;
+
+static bool g_available = false;
+static bool g_groupsAvailable = false;
+static const int MAX_GROUP_DEPTH = 8;
+static const char* g_groupStack[MAX_GROUP_DEPTH];
+static int g_groupDepth = 0;
+
+// Distinct message IDs seen so far and how often each was logged; later IDs are only counted.
+// Slots hold id + 1 (widened, so every GLuint fits) because 0 marks a free slot and 0 is a valid message ID.
+static const int MAX_TRACKED_MESSAGES = 64;
+static std::atomic<uint64_t> g_messageKeys[MAX_TRACKED_MESSAGES];
+static std::atomic<int> g_messageLogged[MAX_TRACKED_MESSAGES];
+
+static const char* typeName(GLenum type) {
+    switch (type) {
+    case GL_DEBUG_TYPE_ERROR:               return "error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+    case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+    case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+    default:                                return "other";
+    }
+}
+
+// Returns false once this message ID was logged often enough
+static bool shouldLog(GLuint id) {
+    const uint64_t key = static_cast<uint64_t>(id) + 1;
+    for (int i = 0; i < MAX_TRACKED_MESSAGES; ++i) {
+        uint64_t expected = 0;
+        if (g_messageKeys[i].load(std::memory_order_relaxed) == key
+            || g_messageKeys[i].compare_exchange_strong(expected, key, std::memory_order_relaxed) || expected == key) {
+            return g_messageLogged[i].fetch_add(1, std::memory_order_relaxed) < MAX_LOGGED_PER_MESSAGE;
+        }
+    }
+    return false;
+}
+
+// May run on a driver thread unless the output is synchronous, so it only touches atomics and the log.
+// The group is read without a lock: it is only used to label the line.
+static void GLAPIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+    const GLchar* message, GLvoid* userParam) {
+    bool isError = type == GL_DEBUG_TYPE_ERROR || type == GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR;
+    metricAdd(isError ? METRIC_GL_DEBUG_ERRORS : METRIC_GL_PERFORMANCE_WARNINGS, 1);
+    if (!shouldLog(id)) return;
+
+    int depth = g_groupDepth;
+    const char* group = depth > 0 && depth <= MAX_GROUP_DEPTH ? g_groupStack[depth - 1] : "no pass";
+    std::cerr << "GL " << typeName(type) << " (frame " << profilerFrame() << ", " << group << ", id " << id << "): "
+        << message << std::endl;
+}
+
+bool glDebugInit(bool enableMessages) {
+    g_available = GLEW_KHR_debug != 0;
+    if (!g_available) {
+        std::cout << "KHR_debug not available, GL objects won't be labeled." << std::endl;
+        return false;
+    }
+    g_popDebugGroup = reinterpret_cast<PopDebugGroupProc>(glfwGetProcAddress("glPopDebugGroup"));
+    g_groupsAvailable = g_popDebugGroup != nullptr;
+    if (!enableMessages) return true;
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT)) {
+        std::cerr << "Not a debug context, the driver may not report GL debug messages." << std::endl;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); // Messages arrive inside the call that caused them, so the frame and pass are right
+    glDebugMessageCallback(debugCallback, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    std::cout << "GL debug messages enabled (performance warnings and errors)." << std::endl;
+    return true;
+}
+
+bool glDebugAvailable() { return g_available; }
+
+void glDebugLabel(GLenum identifier, GLuint name, const char* label) {
+    if (!g_available || name == 0) return;
+    glObjectLabel(identifier, name, -1, label);
+}
+
+void glDebugPushGroup(const char* name) {
+    if (!g_groupsAvailable) return;
+    if (g_groupDepth < MAX_GROUP_DEPTH) g_groupStack[g_groupDepth] = name;
+    g_groupDepth++;
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+}
+
+void glDebugPopGroup() {
+    if (!g_groupsAvailable || g_groupDepth == 0) return;
+    g_groupDepth--;
+    g_popDebugGroup();
+}
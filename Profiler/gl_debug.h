@@ -0,0 +1,23 @@
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+#include "../dependente/glew/glew.h"
+
+// KHR_debug support: names for GL objects, a debug group around every render pass, and the
+// driver's performance warnings in the log. Labels and groups show up in apitrace, RenderDoc and
+// Nsight captures; the log line says in which frame and pass the driver complained.
+// Everything does nothing when the driver has no KHR_debug.
+//
+// Messages need a debug context (the game's --gl-debug). Only performance warnings and errors are
+// logged, each distinct message at most MAX_LOGGED_PER_MESSAGE times; all of them are counted in
+// METRIC_GL_PERFORMANCE_WARNINGS / METRIC_GL_DEBUG_ERRORS.
+static const int MAX_LOGGED_PER_MESSAGE = 5;
+
+bool glDebugInit(bool enableMessages);     // Call once after GLEW; returns false without KHR_debug
+bool glDebugAvailable();
+
+void glDebugLabel(GLenum identifier, GLuint name, const char* label); // identifier: GL_TEXTURE, GL_BUFFER, GL_VERTEX_ARRAY, GL_PROGRAM...
+void glDebugPushGroup(const char* name);   // Name must outlive the group (string literal), it is kept for the log
+void glDebugPopGroup();
+
+#endif // GL_DEBUG_H
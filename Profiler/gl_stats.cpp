@@ -0,0 +1,242 @@
+#define GL_STATS_IMPLEMENTATION // The wrappers below call the real GL functions
+#include "gl_stats.h" // Include the corresponding header file
+
+#include <iomanip>
+#include <iostream>
+
+#include "../Metrics/metrics.h"
+
+static const int GL_STATS_BUCKETS = NUM_RENDER_PASSES + 1;
+
+// GL is only ever called from the main thread, so plain counters are enough
+static GLPassStats g_currentFrame[GL_STATS_BUCKETS];
+static GLPassStats g_lastFrame[GL_STATS_BUCKETS];
+static int g_currentPass = GL_STATS_OTHER;
+static uint32_t g_glStatsFrame = 0;
+
+// Last bound objects, to spot redundant binds (only tracks what goes through the wrappers)
+static const GLuint UNKNOWN_PROGRAM = ~0u; // Never a program name, so no bind compares equal to it
+static GLuint g_boundProgram = 0;
+static GLuint g_boundVertexArray = 0;
+static GLenum g_activeTextureUnit = GL_TEXTURE0;
+static GLuint g_boundTextures[32];  // GL_TEXTURE_2D binding per texture unit
+
+static unsigned int g_maxDrawCalls = 0;
+static uint64_t g_maxUploadBytes = 0;
+static uint32_t g_budgetFailedFrames = 0;
+static const uint32_t MAX_LOGGED_FAILURES = 10;
+
+static const char* g_bucketNames[GL_STATS_BUCKETS] = {
+    "basket", "orbs", "earth particles", "water particles", "fire particles", "air particles", "hud", "messages", "other"
+};
+
+static GLPassStats& current() {
+    return g_currentFrame[g_currentPass];
+}
+
+void glStatsSetPass(int pass) {
+    g_currentPass = (pass >= 0 && pass < GL_STATS_BUCKETS) ? pass : GL_STATS_OTHER;
+}
+
+void glStatsNextFrame() {
+    for (int i = 0; i < GL_STATS_BUCKETS; ++i) {
+        g_lastFrame[i] = g_currentFrame[i];
+        g_currentFrame[i] = GLPassStats();
+    }
+
+    GLPassStats total = glStatsLastFrameTotal();
+    metricSet(METRIC_DRAW_CALLS, total.drawCalls);
+    metricSet(METRIC_DRAW_INSTANCES, total.instances);
+    metricSet(METRIC_DRAW_VERTICES, total.vertices);
+    metricSet(METRIC_GL_STATE_CHANGES, total.stateChanges);
+    metricSet(METRIC_GL_REDUNDANT_STATE_CHANGES, total.redundantChanges);
+    metricSet(METRIC_GL_TEXTURE_BINDS, total.textureBinds);
+    metricSet(METRIC_GL_UPLOAD_BYTES, static_cast<double>(total.uploadBytes));
+    for (int i = 0; i < GL_STATS_BUCKETS; ++i) {
+        metricSet(static_cast<MetricID>(METRIC_DRAW_CALLS_BASKET + i), g_lastFrame[i].drawCalls);
+    }
+
+    bool overDrawCalls = g_maxDrawCalls != 0 && total.drawCalls > g_maxDrawCalls;
+    bool overUpload = g_maxUploadBytes != 0 && total.uploadBytes > g_maxUploadBytes;
+    if (g_glStatsFrame >= GL_STATS_WARMUP_FRAMES && (overDrawCalls || overUpload)) {
+        g_budgetFailedFrames++;
+        metricAdd(METRIC_GL_BUDGET_EXCEEDED_FRAMES, 1);
+        if (g_budgetFailedFrames <= MAX_LOGGED_FAILURES) {
+            std::cerr << "GL budget exceeded in frame " << g_glStatsFrame << ": "
+                << total.drawCalls << " draw calls (max " << g_maxDrawCalls << "), "
+                << total.uploadBytes << " bytes uploaded (max " << g_maxUploadBytes << ")" << std::endl;
+            glStatsPrintLastFrame(std::cerr);
+        }
+    }
+    g_glStatsFrame++;
+}
+
+const GLPassStats& glStatsLastFrame(int pass) {
+    return g_lastFrame[(pass >= 0 && pass < GL_STATS_BUCKETS) ? pass : GL_STATS_OTHER];
+}
+
+GLPassStats glStatsLastFrameTotal() {
+    GLPassStats total = GLPassStats();
+    for (int i = 0; i < GL_STATS_BUCKETS; ++i) {
+        total.drawCalls += g_lastFrame[i].drawCalls;
+        total.instances += g_lastFrame[i].instances;
+        total.vertices += g_lastFrame[i].vertices;
+        total.stateChanges += g_lastFrame[i].stateChanges;
+        total.redundantChanges += g_lastFrame[i].redundantChanges;
+        total.textureBinds += g_lastFrame[i].textureBinds;
+        total.uploadBytes += g_lastFrame[i].uploadBytes;
+    }
+    return total;
+}
+
+void glStatsPrintLastFrame(std::ostream& out) {
+    out << std::left << std::setw(16) << "pass" << std::right
+        << std::setw(7) << "draws" << std::setw(10) << "instances" << std::setw(10) << "vertices"
+        << std::setw(8) << "state" << std::setw(11) << "redundant" << std::setw(11) << "tex binds"
+        << std::setw(14) << "upload bytes" << std::endl;
+    for (int i = 0; i < GL_STATS_BUCKETS; ++i) {
+        const GLPassStats& s = g_lastFrame[i];
+        out << std::left << std::setw(16) << g_bucketNames[i] << std::right
+            << std::setw(7) << s.drawCalls << std::setw(10) << s.instances << std::setw(10) << s.vertices
+            << std::setw(8) << s.stateChanges << std::setw(11) << s.redundantChanges << std::setw(11) << s.textureBinds
+            << std::setw(14) << s.uploadBytes << std::endl;
+    }
+}
+
+void glStatsSetBudget(unsigned int maxDrawCalls, uint64_t maxUploadBytes) {
+    g_maxDrawCalls = maxDrawCalls;
+    g_maxUploadBytes = maxUploadBytes;
+}
+
+bool glStatsBudgetFailed() { return g_budgetFailedFrames > 0; }
+
+// Counting wrappers
+
+void glStatsDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    GLPassStats& s = current();
+    s.drawCalls++;
+    s.instances++;
+    s.vertices += count;
+    glDrawArrays(mode, first, count);
+}
+
+void glStatsDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
+    GLPassStats& s = current();
+    s.drawCalls++;
+    s.instances += instanceCount;
+    s.vertices += count * instanceCount;
+    glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+}
+
+void glStatsUseProgram(GLuint program) {
+    GLPassStats& s = current();
+    s.stateChanges++;
+    if (program == g_boundProgram) s.redundantChanges++;
+    g_boundProgram = program;
+    glUseProgram(program);
+}
+
+void glStatsBindVertexArray(GLuint array) {
+    GLPassStats& s = current();
+    s.stateChanges++;
+    if (array == g_boundVertexArray) s.redundantChanges++;
+    g_boundVertexArray = array;
+    glBindVertexArray(array);
+}
+
+void glStatsBindBuffer(GLenum target, GLuint buffer) {
+    current().stateChanges++;
+    glBindBuffer(target, buffer);
+}
+
+void glStatsBindTexture(GLenum target, GLuint texture) {
+    GLPassStats& s = current();
+    s.stateChanges++;
+    s.textureBinds++;
+    unsigned int unit = g_activeTextureUnit - GL_TEXTURE0;
+    if (target == GL_TEXTURE_2D && unit < 32) {
+        if (texture == g_boundTextures[unit]) s.redundantChanges++;
+        g_boundTextures[unit] = texture;
+    }
+    glBindTexture(target, texture);
+}
+
+void glStatsActiveTexture(GLenum texture) {
+    current().stateChanges++;
+    g_activeTextureUnit = texture;
+    glActiveTexture(texture);
+}
+
+void glStatsEnable(GLenum cap) {
+    current().stateChanges++;
+    glEnable(cap);
+}
+
+void glStatsDisable(GLenum cap) {
+    current().stateChanges++;
+    glDisable(cap);
+}
+
+void glStatsBlendFunc(GLenum sfactor, GLenum dfactor) {
+    current().stateChanges++;
+    glBlendFunc(sfactor, dfactor);
+}
+
+void glStatsUniform1i(GLint location, GLint v0) {
+    current().stateChanges++;
+    glUniform1i(location, v0);
+}
+
+void glStatsUniform1f(GLint location, GLfloat v0) {
+    current().stateChanges++;
+    glUniform1f(location, v0);
+}
+
+void glStatsUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+    current().stateChanges++;
+    glUniform2f(location, v0, v1);
+}
+
+void glStatsUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+    current().stateChanges++;
+    glUniform4fv(location, count, value);
+}
+
+void glStatsUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    current().stateChanges++;
+    glUniformMatrix4fv(location, count, transpose, value);
+}
+
+void glStatsBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    if (data != nullptr) current().uploadBytes += size; // A NULL data pointer only (re)allocates storage
+    glBufferData(target, size, data, usage);
+}
+
+void glStatsBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    current().uploadBytes += size;
+    glBufferSubData(target, offset, size, data);
+}
+
+// Deleting a bound texture or vertex array resets that binding to 0
+void glStatsDeleteTextures(GLsizei n, const GLuint* textures) {
+    for (GLsizei i = 0; i < n; ++i) {
+        for (GLuint& bound : g_boundTextures) {
+            if (bound == textures[i]) bound = 0;
+        }
+    }
+    glDeleteTextures(n, textures);
+}
+
+void glStatsDeleteVertexArrays(GLsizei n, const GLuint* arrays) {
+    for (GLsizei i = 0; i < n; ++i) {
+        if (g_boundVertexArray == arrays[i]) g_boundVertexArray = 0;
+    }
+    glDeleteVertexArrays(n, arrays);
+}
+
+// A program in use stays current after the delete and its name may come back, so the next glUseProgram
+// can't be judged redundant whatever it binds
+void glStatsDeleteProgram(GLuint program) {
+    if (program != 0 && g_boundProgram == program) g_boundProgram = UNKNOWN_PROGRAM;
+    glDeleteProgram(program);
+}
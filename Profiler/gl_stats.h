@@ -0,0 +1,106 @@
+#ifndef GL_STATS_H
+#define GL_STATS_H
+
+#include <cstdint>
+#include <ostream>
+
+#include "../dependente/glew/glew.h"
+#include "gpu_timer.h"
+
+// GL command statistics.
+// Including this header (after GLEW) redirects the GL calls the game makes to counting wrappers,
+// which forward to the real functions. Every frame the counts are broken down by render pass
+// (the pass the GpuPassTimer currently has open) and published as metrics.
+// Define DISABLE_GL_STATS to call GL directly.
+
+static const int GL_STATS_OTHER = NUM_RENDER_PASSES;   // Bucket for commands outside any timed pass
+static const uint32_t GL_STATS_WARMUP_FRAMES = 120;    // Budgets aren't checked while loading
+
+struct GLPassStats {
+    unsigned int drawCalls;
+    unsigned int instances;         // 1 per non-instanced draw
+    unsigned int vertices;          // Vertices (or indices) processed, times instances
+    unsigned int stateChanges;      // Program, VAO, buffer, texture unit and fixed-function state, uniforms
+    unsigned int redundantChanges;  // Binds of the program, VAO or texture that was already bound
+    unsigned int textureBinds;
+    uint64_t uploadBytes;           // glBufferData / glBufferSubData
+};
+
+void glStatsSetPass(int pass);                  // Called by GpuPassTimer when a pass begins (GL_STATS_OTHER when it ends)
+void glStatsNextFrame();                        // Call once per frame, publishes the finished frame
+const GLPassStats& glStatsLastFrame(int pass);  // Counts of the last finished frame, per pass or GL_STATS_OTHER
+GLPassStats glStatsLastFrameTotal();
+void glStatsPrintLastFrame(std::ostream& out);  // Per-pass table of the last finished frame
+
+// Budgets (0 means unlimited). Frames over budget after warm-up are logged and make glStatsBudgetFailed() true.
+void glStatsSetBudget(unsigned int maxDrawCalls, uint64_t maxUploadBytes);
+bool glStatsBudgetFailed();
+
+// Counting wrappers, same signatures as the GL functions
+void glStatsDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glStatsDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+void glStatsUseProgram(GLuint program);
+void glStatsBindVertexArray(GLuint array);
+void glStatsBindBuffer(GLenum target, GLuint buffer);
+void glStatsBindTexture(GLenum target, GLuint texture);
+void glStatsActiveTexture(GLenum texture);
+void glStatsEnable(GLenum cap);
+void glStatsDisable(GLenum cap);
+void glStatsBlendFunc(GLenum sfactor, GLenum dfactor);
+void glStatsUniform1i(GLint location, GLint v0);
+void glStatsUniform1f(GLint location, GLfloat v0);
+void glStatsUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void glStatsUniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void glStatsUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void glStatsBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glStatsBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+// Deletes aren't counted, they only forget the deleted names so a later bind isn't taken for a redundant one
+void glStatsDeleteTextures(GLsizei n, const GLuint* textures);
+void glStatsDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glStatsDeleteProgram(GLuint program);
+
+#if !defined(DISABLE_GL_STATS) && !defined(GL_STATS_IMPLEMENTATION)
+// GLEW defines most of these as macros for its function pointers, so they have to be undefined first
+#undef glDrawArrays
+#undef glDrawElementsInstanced
+#undef glUseProgram
+#undef glBindVertexArray
+#undef glBindBuffer
+#undef glBindTexture
+#undef glActiveTexture
+#undef glEnable
+#undef glDisable
+#undef glBlendFunc
+#undef glUniform1i
+#undef glUniform1f
+#undef glUniform2f
+#undef glUniform4fv
+#undef glUniformMatrix4fv
+#undef glBufferData
+#undef glBufferSubData
+#undef glDeleteTextures
+#undef glDeleteVertexArrays
+#undef glDeleteProgram
+#define glDrawArrays glStatsDrawArrays
+#define glDrawElementsInstanced glStatsDrawElementsInstanced
+#define glUseProgram glStatsUseProgram
+#define glBindVertexArray glStatsBindVertexArray
+#define glBindBuffer glStatsBindBuffer
+#define glBindTexture glStatsBindTexture
+#define glActiveTexture glStatsActiveTexture
+#define glEnable glStatsEnable
+#define glDisable glStatsDisable
+#define glBlendFunc glStatsBlendFunc
+#define glUniform1i glStatsUniform1i
+#define glUniform1f glStatsUniform1f
+#define glUniform2f glStatsUniform2f
+#define glUniform4fv glStatsUniform4fv
+#define glUniformMatrix4fv glStatsUniformMatrix4fv
+#define glBufferData glStatsBufferData
+#define glBufferSubData glStatsBufferSubData
+#define glDeleteTextures glStatsDeleteTextures
+#define glDeleteVertexArrays glStatsDeleteVertexArrays
+#define glDeleteProgram glStatsDeleteProgram
+#endif
+
+#endif // GL_STATS_H
@@ -0,0 +1,93 @@
+#include "gpu_timer.h" // Include the corresponding header file
+
+#include "gl_debug.h"
+#include "gl_stats.h"
+#include "profiler.h"
+#include "../Metrics/metrics.h"
+
+GpuPassTimer::GpuPassTimer() : m_currentSlot(0), m_initialized(false) {
+    for (int slot = 0; slot < QUERY_FRAMES; ++slot) {
+        for (int pass = 0; pass < NUM_RENDER_PASSES; ++pass) {
+            m_queries[slot][pass] = 0;
+            m_issued[slot][pass] = false;
+        }
+    }
+    for (int pass = 0; pass < NUM_RENDER_PASSES; ++pass) {
+        m_cpuStartNs[pass] = 0;
+    }
+}
+
+GpuPassTimer::~GpuPassTimer() {
+    if (m_initialized) {
+        glDeleteQueries(QUERY_FRAMES * NUM_RENDER_PASSES, &m_queries[0][0]);
+    }
+}
+
+void GpuPassTimer::init() {
+    glGenQueries(QUERY_FRAMES * NUM_RENDER_PASSES, &m_queries[0][0]);
+    m_initialized = true;
+}
+
+// Moves to the next slot. That slot was filled QUERY_FRAMES - 1 frames ago,
+// so its results are normally available; if one isn't, it is dropped rather than waited for.
+void GpuPassTimer::beginFrame() {
+    if (!m_initialized) return;
+
+    m_currentSlot = (m_currentSlot + 1) % QUERY_FRAMES;
+
+    for (int pass = 0; pass < NUM_RENDER_PASSES; ++pass) {
+        MetricID gpuMetric = static_cast<MetricID>(METRIC_GPU_PASS_BASKET_MS + pass);
+        if (!m_issued[m_currentSlot][pass]) {
+            metricSet(gpuMetric, 0.0); // The pass didn't run in that frame
+            continue;
+        }
+
+        GLuint query = m_queries[m_currentSlot][pass];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+            metricSet(gpuMetric, elapsedNs / 1000000.0);
+        }
+        else {
+            metricAdd(METRIC_GPU_QUERIES_NOT_READY, 1);
+        }
+        m_issued[m_currentSlot][pass] = false;
+    }
+}
+
+void GpuPassTimer::begin(RenderPass pass) {
+    m_cpuStartNs[pass] = profilerNow();
+    glStatsSetPass(pass); // GL commands until end() are counted for this pass
+    glDebugPushGroup(passName(pass));
+    if (!m_initialized) return;
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_currentSlot][pass]);
+}
+
+void GpuPassTimer::end(RenderPass pass) {
+    if (m_initialized) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_issued[m_currentSlot][pass] = true;
+    }
+    glDebugPopGroup();
+    glStatsSetPass(GL_STATS_OTHER);
+
+    uint64_t endNs = profilerNow();
+    profilerRecord(passName(pass), m_cpuStartNs[pass], endNs); // Also visible in the CPU trace
+    metricSet(static_cast<MetricID>(METRIC_CPU_PASS_BASKET_MS + pass), (endNs - m_cpuStartNs[pass]) / 1000000.0);
+}
+
+const char* GpuPassTimer::passName(RenderPass pass) {
+    switch (pass) {
+    case RENDER_PASS_BASKET:            return "pass: basket";
+    case RENDER_PASS_ORBS:              return "pass: orbs";
+    case RENDER_PASS_PARTICLES_EARTH:   return "pass: earth particles";
+    case RENDER_PASS_PARTICLES_WATER:   return "pass: water particles";
+    case RENDER_PASS_PARTICLES_FIRE:    return "pass: fire particles";
+    case RENDER_PASS_PARTICLES_AIR:     return "pass: air particles";
+    case RENDER_PASS_HUD:               return "pass: hud";
+    case RENDER_PASS_MESSAGES:          return "pass: messages";
+    default:                            return "pass: unknown";
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <cstdint>
+
+#include "../dependente/glew/glew.h"
+
+// Render passes timed separately, in the order Game::draw submits them
+enum RenderPass {
+    RENDER_PASS_BASKET = 0,
+    RENDER_PASS_ORBS,
+    RENDER_PASS_PARTICLES_EARTH,    // Particle passes follow ElementType order
+    RENDER_PASS_PARTICLES_WATER,
+    RENDER_PASS_PARTICLES_FIRE,
+    RENDER_PASS_PARTICLES_AIR,
+    RENDER_PASS_HUD,
+    RENDER_PASS_MESSAGES,
+    NUM_RENDER_PASSES
+};
+
+// Measures every render pass on the GPU with GL_TIME_ELAPSED queries, and on the CPU.
+// Queries live in a ring of QUERY_FRAMES slots: the results of a frame are only read
+// back when its slot comes around again, by which time the GPU has finished with it,
+// so reading never stalls. Results are published as METRIC_CPU_PASS_* / METRIC_GPU_PASS_*.
+// Each pass is also a KHR_debug group named after it (see gl_debug.h).
+class GpuPassTimer {
+public:
+    static const int QUERY_FRAMES = 4; // Frames of latency before a result is read
+
+    GpuPassTimer();
+    ~GpuPassTimer();
+
+    void init();                    // Creates the query objects (needs a GL context)
+    void beginFrame();              // Collects the oldest frame's results and reuses its slot
+    void begin(RenderPass pass);
+    void end(RenderPass pass);
+
+    static const char* passName(RenderPass pass);
+
+private:
+    GLuint m_queries[QUERY_FRAMES][NUM_RENDER_PASSES];
+    bool m_issued[QUERY_FRAMES][NUM_RENDER_PASSES]; // Whether the pass ran in that frame
+    uint64_t m_cpuStartNs[NUM_RENDER_PASSES];
+    int m_currentSlot;
+    bool m_initialized;
+};
+
+// Times one pass for the lifetime of the scope (passes must not overlap)
+class GpuPassScope {
+public:
+    GpuPassScope(GpuPassTimer& timer, RenderPass pass) : m_timer(timer), m_pass(pass) { m_timer.begin(m_pass); }
+    ~GpuPassScope() { m_timer.end(m_pass); }
+
+private:
+    GpuPassTimer& m_timer;
+    RenderPass m_pass;
+};
+
+#endif // GPU_TIMER_H
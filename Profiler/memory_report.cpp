@@ -0,0 +1,84 @@
+#include "memory_report.h" // Include the corresponding header file
+
+#include <iomanip>
+
+#include "../Metrics/metrics.h"
+#include "../Metrics/soak_recorder.h"
+#include "gl_stats.h"    // textureBytes binds textures, the redundant-bind tracking has to see that
+
+static const char* g_subsystemNames[NUM_MEMORY_SUBSYSTEMS] = {
+    "textures", "earth particles", "water particles", "fire particles", "air particles",
+    "orbs", "audio", "shaders", "diagnostics", "frame arena", "meshes"
+};
+
+static MetricID cpuMetric(MemorySubsystem subsystem) {
+    return static_cast<MetricID>(METRIC_MEM_CPU_TEXTURES + subsystem);
+}
+
+static MetricID gpuMetric(MemorySubsystem subsystem) {
+    return static_cast<MetricID>(METRIC_MEM_GPU_TEXTURES + subsystem);
+}
+
+void memoryAdd(MemorySubsystem subsystem, double cpuBytes, double gpuBytes) {
+    if (cpuBytes != 0.0) metricAdd(cpuMetric(subsystem), cpuBytes);
+    if (gpuBytes != 0.0) metricAdd(gpuMetric(subsystem), gpuBytes);
+}
+
+void memorySet(MemorySubsystem subsystem, double cpuBytes, double gpuBytes) {
+    metricSet(cpuMetric(subsystem), cpuBytes);
+    metricSet(gpuMetric(subsystem), gpuBytes);
+}
+
+double memoryCpuBytes(MemorySubsystem subsystem) { return metricGet(cpuMetric(subsystem)); }
+double memoryGpuBytes(MemorySubsystem subsystem) { return metricGet(gpuMetric(subsystem)); }
+
+double memoryTotalCpuBytes() {
+    double total = 0.0;
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; ++i) total += memoryCpuBytes(static_cast<MemorySubsystem>(i));
+    return total;
+}
+
+double memoryTotalGpuBytes() {
+    double total = 0.0;
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; ++i) total += memoryGpuBytes(static_cast<MemorySubsystem>(i));
+    return total;
+}
+
+// Sizes in KB. What the process holds beyond the tracked total is code, the C runtime, drivers and untracked allocations.
+void printMemoryReport(std::ostream& out) {
+    out << std::left << std::setw(16) << "subsystem" << std::right
+        << std::setw(12) << "CPU KB" << std::setw(12) << "GPU KB" << std::endl;
+    out << std::fixed << std::setprecision(1);
+    for (int i = 0; i < NUM_MEMORY_SUBSYSTEMS; ++i) {
+        MemorySubsystem subsystem = static_cast<MemorySubsystem>(i);
+        out << std::left << std::setw(16) << g_subsystemNames[i] << std::right
+            << std::setw(12) << memoryCpuBytes(subsystem) / 1024.0 << std::setw(12) << memoryGpuBytes(subsystem) / 1024.0 << std::endl;
+    }
+    out << std::left << std::setw(16) << "total" << std::right
+        << std::setw(12) << memoryTotalCpuBytes() / 1024.0 << std::setw(12) << memoryTotalGpuBytes() / 1024.0 << std::endl;
+
+    uint64_t rss = processResidentBytes();
+    if (rss != 0) {
+        metricSet(METRIC_PROCESS_RSS_BYTES, static_cast<double>(rss));
+        out << std::left << std::setw(16) << "process RSS" << std::right << std::setw(12) << rss / 1024.0 << std::endl;
+    }
+    out.unsetf(std::ios::floatfield);
+}
+
+double textureBytes(GLuint texture) {
+    if (texture == 0 || !glIsTexture(texture)) return 0.0; // Binding a deleted name is an error in a core profile
+    GLint width = 0, height = 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return width * height * 4 * 4.0 / 3.0; // Drivers usually store 4 bytes per texel, mipmaps add a third
+}
+
+// GL_PROGRAM_BINARY_LENGTH needs ARB_get_program_binary (core since 4.1), most 3.3 drivers have it
+double programBytes(GLuint program) {
+    if (program == 0 || !GLEW_ARB_get_program_binary) return 0.0;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    return length;
+}
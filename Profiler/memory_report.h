@@ -0,0 +1,43 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <ostream>
+
+#include "../dependente/glew/glew.h"
+
+// Subsystems whose memory is accounted separately. Particle pools follow ElementType order.
+enum MemorySubsystem {
+    MEMORY_TEXTURES = 0,
+    MEMORY_PARTICLES_EARTH,
+    MEMORY_PARTICLES_WATER,
+    MEMORY_PARTICLES_FIRE,
+    MEMORY_PARTICLES_AIR,
+    MEMORY_ORBS,
+    MEMORY_AUDIO,
+    MEMORY_SHADERS,
+    MEMORY_DIAGNOSTICS,     // Profiler event buffers, overlay, soak recorder rows
+    MEMORY_FRAME_ARENA,     // Per-frame scratch memory (see Memory/frame_arena.h)
+    MEMORY_MESHES,          // Shared meshes (see Mesh/mesh_registry.h)
+    NUM_MEMORY_SUBSYSTEMS
+};
+
+// Memory held per subsystem, in system memory (CPU) and video memory (GPU).
+// Owners report what they allocate and release, the totals live in the METRIC_MEM_* metrics,
+// so they show up in the overlay, the metrics endpoint and the exit report.
+// GPU sizes are estimates: the driver doesn't say how it actually stores a buffer or texture.
+void memoryAdd(MemorySubsystem subsystem, double cpuBytes, double gpuBytes);   // Negative amounts release
+void memorySet(MemorySubsystem subsystem, double cpuBytes, double gpuBytes);   // For subsystems recounted every tick
+
+double memoryCpuBytes(MemorySubsystem subsystem);
+double memoryGpuBytes(MemorySubsystem subsystem);
+double memoryTotalCpuBytes();
+double memoryTotalGpuBytes();
+
+// Table of every subsystem with totals and the process resident size
+void printMemoryReport(std::ostream& out);
+
+// Size helpers for GL objects (need a current context)
+double textureBytes(GLuint texture);        // Level 0 at 4 bytes per texel, plus a third for mipmaps
+double programBytes(GLuint program);        // Size of the linked binary, 0 if the driver can't tell
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,120 @@
+#include "profiler.h" // Include the corresponding header file
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "memory_report.h"
+
+// One recorded scope
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t frame;
+};
+
+// Ring of the most recent events of one thread. Only that thread writes to it;
+// 'written' is published with release so the exporter sees complete events.
+static const size_t EVENTS_PER_THREAD = 16384;
+
+struct ThreadEventBuffer {
+    ProfileEvent events[EVENTS_PER_THREAD];
+    std::atomic<uint64_t> written;  // Total events ever recorded, the ring index is written % EVENTS_PER_THREAD
+    uint32_t threadIndex;           // Small id used as "tid" in the trace
+};
+
+static const std::chrono::steady_clock::time_point g_profilerStart = std::chrono::steady_clock::now();
+static std::atomic<uint32_t> g_currentFrame(0);
+
+// Buffers are created the first time a thread records something and live until exit,
+// so a trace can still include threads that have already finished.
+static std::mutex g_bufferListMutex;
+static std::vector<std::unique_ptr<ThreadEventBuffer>> g_buffers;
+static thread_local ThreadEventBuffer* t_buffer = nullptr;
+
+// Registers a buffer for the calling thread (the only place a lock is taken, once per thread)
+static ThreadEventBuffer* createThreadBuffer() {
+    std::unique_ptr<ThreadEventBuffer> buffer(new ThreadEventBuffer());
+    buffer->written.store(0, std::memory_order_relaxed);
+
+    memoryAdd(MEMORY_DIAGNOSTICS, sizeof(ThreadEventBuffer), 0.0); // Kept until exit, like the buffer
+
+    std::lock_guard<std::mutex> lock(g_bufferListMutex);
+    buffer->threadIndex = static_cast<uint32_t>(g_buffers.size());
+    g_buffers.push_back(std::move(buffer));
+    return g_buffers.back().get();
+}
+
+uint64_t profilerNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_profilerStart).count());
+}
+
+void profilerRecord(const char* name, uint64_t startNs, uint64_t endNs) {
+    if (t_buffer == nullptr) {
+        t_buffer = createThreadBuffer();
+    }
+
+    uint64_t index = t_buffer->written.load(std::memory_order_relaxed);
+    ProfileEvent& event = t_buffer->events[index % EVENTS_PER_THREAD];
+    event.name = name;
+    event.startNs = startNs;
+    event.endNs = endNs;
+    event.frame = g_currentFrame.load(std::memory_order_relaxed);
+    t_buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void profilerNextFrame() {
+    g_currentFrame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t profilerFrame() {
+    return g_currentFrame.load(std::memory_order_relaxed);
+}
+
+// Writes every event from the last frameCount frames, of every thread, as complete ("X") events.
+// Timestamps in the Chrome format are microseconds.
+bool profilerExportChromeTrace(const char* path, uint32_t frameCount) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t lastFrame = profilerFrame();
+    uint32_t firstFrame = lastFrame >= frameCount ? lastFrame - frameCount + 1 : 0; // The current frame counts as one
+    size_t eventCount = 0;
+
+    out << std::fixed << std::setprecision(3); // Microseconds with ns resolution, never scientific notation
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    std::lock_guard<std::mutex> lock(g_bufferListMutex);
+    for (const auto& buffer : g_buffers) {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        // Skip the oldest quarter of a full ring, the owning thread may be overwriting it right now
+        uint64_t first = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD * 3 / 4 : 0;
+
+        for (uint64_t i = first; i < written; ++i) {
+            const ProfileEvent& event = buffer->events[i % EVENTS_PER_THREAD];
+            if (event.frame < firstFrame) continue;
+
+            if (eventCount > 0) out << ",\n";
+            out << "{\"name\":\"" << event.name << "\",\"cat\":\"cpu\",\"ph\":\"X\""
+                << ",\"ts\":" << event.startNs / 1000.0
+                << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0
+                << ",\"pid\":1,\"tid\":" << buffer->threadIndex
+                << ",\"args\":{\"frame\":" << event.frame << "}}";
+            eventCount++;
+        }
+    }
+
+    out << "\n]}\n";
+    std::cout << "Wrote " << eventCount << " profiler events (" << (lastFrame - firstFrame + 1) << " frames) to " << path << std::endl;
+    return true;
+}
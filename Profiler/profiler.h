@@ -0,0 +1,38 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+
+// Lightweight CPU profiler.
+// PROFILE_SCOPE("name") records the begin/end time of the enclosing scope into a ring
+// buffer owned by the calling thread, so recording never takes a lock. The last frames
+// can be exported on demand as Chrome trace-event JSON (open it in chrome://tracing or Perfetto).
+// Define DISABLE_PROFILER to compile all PROFILE_SCOPE markers out.
+
+uint64_t profilerNow();                                             // Nanoseconds since the program started
+void profilerRecord(const char* name, uint64_t startNs, uint64_t endNs); // Stores one finished scope for this thread
+void profilerNextFrame();                                           // Call once at the top of every frame
+uint32_t profilerFrame();                                           // Index of the current frame
+bool profilerExportChromeTrace(const char* path, uint32_t frameCount); // Writes the last frameCount frames
+
+// Records the lifetime of a scope. Names must be string literals (only the pointer is stored).
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_name(name), m_startNs(profilerNow()) {}
+    ~ProfileScope() { profilerRecord(m_name, m_startNs, profilerNow()); }
+
+private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef DISABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
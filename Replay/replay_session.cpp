@@ -0,0 +1,105 @@
+#include "replay_session.h" // Include the corresponding header file
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static const char* REPLAY_MAGIC = "ELEMENT_BASKET_REPLAY";
+static const int REPLAY_VERSION = 2;
+static const int REPLAY_VERSION_WHOLE_TICKS = 1; // Before held shares, still loaded
+static const float DEFAULT_DELTA_TIME = 1.0f / 60.0f;
+
+enum ReplayButtons {
+    REPLAY_BUTTON_LEFT = 1,
+    REPLAY_BUTTON_RIGHT = 2,
+    REPLAY_BUTTON_RESTART = 4
+};
+
+ReplaySession::ReplaySession() : seed(0), screenWidth(1024), screenHeight(768) {}
+
+bool ReplaySession::load(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        std::cerr << "Failed to open replay session: " << path << std::endl;
+        return false;
+    }
+
+    char magic[32] = {};
+    int version = 0;
+    unsigned int fileSeed = 0;
+    unsigned int tickCount = 0;
+    bool valid = fscanf(file, "%31s %d", magic, &version) == 2 && strcmp(magic, REPLAY_MAGIC) == 0
+        && (version == REPLAY_VERSION || version == REPLAY_VERSION_WHOLE_TICKS)
+        && fscanf(file, " seed %u", &fileSeed) == 1
+        && fscanf(file, " screen %d %d", &screenWidth, &screenHeight) == 2
+        && fscanf(file, " ticks %u", &tickCount) == 1;
+
+    ticks.clear();
+    if (valid) {
+        ticks.reserve(tickCount);
+        seed = fileSeed;
+        for (unsigned int i = 0; i < tickCount; ++i) {
+            ReplayTick tick;
+            int buttons = 0;
+            if (fscanf(file, "%f %d %d", &tick.deltaTime, &buttons, &tick.input.scroll) != 3) {
+                valid = false;
+                break;
+            }
+            if (version == REPLAY_VERSION_WHOLE_TICKS) {
+                tick.input.leftHeld = (buttons & REPLAY_BUTTON_LEFT) != 0 ? 1.0f : 0.0f;
+                tick.input.rightHeld = (buttons & REPLAY_BUTTON_RIGHT) != 0 ? 1.0f : 0.0f;
+            }
+            else if (fscanf(file, "%f %f", &tick.input.leftHeld, &tick.input.rightHeld) != 2) {
+                valid = false;
+                break;
+            }
+            tick.input.restart = (buttons & REPLAY_BUTTON_RESTART) != 0;
+            ticks.push_back(tick);
+        }
+    }
+    fclose(file);
+
+    if (!valid) {
+        std::cerr << "Replay session is damaged or from another version: " << path << std::endl;
+        ticks.clear();
+        return false;
+    }
+    return true;
+}
+
+// %.9g round-trips every float, so a saved session replays bit for bit
+bool ReplaySession::save(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        std::cerr << "Failed to write replay session: " << path << std::endl;
+        return false;
+    }
+
+    fprintf(file, "%s %d\nseed %u\nscreen %d %d\nticks %u\n", REPLAY_MAGIC, REPLAY_VERSION,
+        static_cast<unsigned int>(seed), screenWidth, screenHeight, static_cast<unsigned int>(ticks.size()));
+    for (const ReplayTick& tick : ticks) {
+        // The buttons are redundant with the held shares, they keep the file readable
+        int buttons = (tick.input.leftHeld > 0.0f ? REPLAY_BUTTON_LEFT : 0) | (tick.input.rightHeld > 0.0f ? REPLAY_BUTTON_RIGHT : 0)
+            | (tick.input.restart ? REPLAY_BUTTON_RESTART : 0);
+        fprintf(file, "%.9g %d %d %.9g %.9g\n", tick.deltaTime, buttons, tick.input.scroll, tick.input.leftHeld, tick.input.rightHeld);
+    }
+    bool written = ferror(file) == 0;
+    fclose(file);
+
+    std::cout << "Recorded " << ticks.size() << " ticks to " << path << std::endl;
+    return written;
+}
+
+void ReplaySession::addTick(float deltaTime, const InputFrame& input) {
+    ReplayTick tick;
+    tick.deltaTime = deltaTime;
+    tick.input = input;
+    ticks.push_back(tick);
+}
+
+ReplayTick ReplaySession::getTick(size_t index) const {
+    if (index < ticks.size()) return ticks[index];
+    ReplayTick idle;
+    idle.deltaTime = ticks.empty() ? DEFAULT_DELTA_TIME : ticks.back().deltaTime;
+    return idle;
+}
@@ -0,0 +1,49 @@
+#ifndef REPLAY_SESSION_H
+#define REPLAY_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Everything the player can do in one tick
+struct InputFrame {
+    float leftHeld;     // Share of the tick A was held: 1 for the whole tick, 0 not at all (a short tap can count for more)
+    float rightHeld;    // Same for D
+    bool restart;
+    int scroll;         // Scroll steps since the last tick, positive is up
+
+    InputFrame() : leftHeld(0.0f), rightHeld(0.0f), restart(false), scroll(0) {}
+};
+
+// One recorded tick: its input and the delta time the game was updated with
+struct ReplayTick {
+    float deltaTime;
+    InputFrame input;
+};
+
+// A recorded session: the seed the game ran with, the screen size and the input of every tick.
+// Given the same seed, Game replays the session exactly (window resizes aren't recorded).
+// Stored as text, one tick per line, so sessions can be diffed and edited by hand:
+//   ELEMENT_BASKET_REPLAY 2
+//   seed <n>
+//   screen <width> <height>
+//   ticks <n>
+//   <deltaTime> <buttons: 1 left, 2 right, 4 restart> <scroll> <leftHeld> <rightHeld>   (once per tick)
+// Version 1 sessions have no held shares; they load with the whole tick for every pressed button.
+class ReplaySession {
+public:
+    ReplaySession();
+
+    bool load(const char* path);
+    bool save(const char* path) const;
+
+    void addTick(float deltaTime, const InputFrame& input);
+    // Past the last recorded tick there is no input, at the last delta time
+    ReplayTick getTick(size_t index) const;
+
+    uint32_t seed;
+    int screenWidth, screenHeight;
+    std::vector<ReplayTick> ticks;
+};
+
+#endif // REPLAY_SESSION_H
@@ -4,9 +4,10 @@
 #include <iostream>
 #include <vector>
 #include <memory>           // For std::unique_ptr
-#include <algorithm>        // For std::remove_if
+#include <algorithm>        // For std::max and std::sort
 #include <random>           // For random number generation
 #include <string>           // For texture paths
+#include <cstring>          // For strcmp on command line arguments
 
 #define _USE_MATH_DEFINES   // For PI
 #include <cmath>            // For fabs in particle velocity
@@ -20,7 +21,29 @@
 
 // Include helpers
 #include "Camera/camera.h"
+#include "Collision/alpha_mask.h"
+#include "Input/key_intervals.h"
 #include "shader.hpp"
+#include "Audio/audio_system.h"
+#include "Metrics/metrics.h"
+#include "Metrics/metrics_server.h"
+#include "Metrics/soak_recorder.h"
+#include "Profiler/profiler.h"
+#include "Profiler/gpu_timer.h"
+#include "Profiler/alloc_tracker.h"
+#include "Profiler/gl_stats.h"    // Counts every GL call below, so include it after GLEW
+#include "Profiler/gl_debug.h"
+#include "Profiler/memory_report.h"
+#include "Memory/frame_arena.h"
+#include "Memory/ring_buffer.h"
+#include "Mesh/mesh_registry.h"
+#include "Replay/replay_session.h"
+#include "Overlay/perf_overlay.h"
+#include "Pacing/frame_pacer.h"
+#ifdef BENCHMARK
+#include "Benchmark/benchmark.h"
+#include "Benchmark/replay_harness.h"
+#endif
 
 // Single-file header for image loading
 #define STB_IMAGE_IMPLEMENTATION
@@ -79,6 +102,8 @@ static GLuint loadTextureUtility(const char* path) {
         // Upload texture data to the GPU
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D); // Generate mipmaps for smoother scaling
+        glDebugLabel(GL_TEXTURE, textureID, path); // Captures and GL debug messages show the file name
+        memoryAdd(MEMORY_TEXTURES, 0.0, width * height * 4 * 4.0 / 3.0); // Drivers usually store 4 bytes per texel, mipmaps add a third
         std::cout << "Successfully loaded texture: " << path << " (Width: " << width << ", Height: " << height << ", Channels: " << nrChannels << ")" << std::endl;
     }
     else {
@@ -90,12 +115,34 @@ static GLuint loadTextureUtility(const char* path) {
     return textureID; // Return the OpenGL texture ID
 }
 
+// Deletes a texture created by loadTextureUtility and takes it out of the memory report.
+static void deleteTextureUtility(GLuint textureID) {
+    if (textureID == 0) return;
+    memoryAdd(MEMORY_TEXTURES, 0.0, -textureBytes(textureID));
+    glDeleteTextures(1, &textureID);
+}
+
+
+// Folds raw bytes into an FNV-1a hash, for cheap "did anything change" checks.
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
 
-// Base class for game objects
+static const uint64_t HASH_SEED = 14695981039346656037ull; // FNV-1a offset basis
+
+// Base class for game objects.
+// Nothing here is virtual: every collection holds one concrete type (the basket, a vector of orbs,
+// the plain quads of the HUD), so calls bind at compile time and the per-frame loops can be inlined.
+// Derived classes hide init() and draw() rather than override them, and objects are never deleted
+// through a GameObject pointer. Geometry comes from the shared MeshRegistry; the texture is owned,
+// so objects can be moved but not copied.
 class GameObject {
 protected:
-    GLuint VAO, VBO;                // Vertex Array Object, Vertex Buffer Object
-    std::vector<float> vertices;    // Stores vertex data (position, normal, texture coordinates)
+    const Mesh* m_mesh;             // Shared mesh from the MeshRegistry, null until init()
     glm::vec3 position;             // World position of the object
     glm::vec3 scale;                // Scale of the object (width, height, depth)
     glm::vec4 color;                // Base color or tint for the object
@@ -103,18 +150,19 @@ public:                             // Made public so Game can set it for score
     GLuint textureID;               // OpenGL texture ID for the object's texture
 protected:
 
-    void setupMesh();                       // Initializes VAO and VBO with vertex data
     void loadTexture(const char* path);     // Loads texture using the utility function
 
 public:
     GameObject();
-    virtual ~GameObject();
+    ~GameObject();
+    GameObject(GameObject&& other) noexcept;
+    GameObject& operator=(GameObject&& other) noexcept;
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
 
-    // Virtual functions for object-specific behavior
-    virtual void init();
-    // Modified update to accept a Game* for potential interaction
-    virtual void update(float deltaTime, Game* gameInstance = nullptr);
-    virtual void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection);
+    void init();
+    // View and projection are uploaded once per program by Game::draw, only when the camera changes
+    void draw(GLuint shaderProgram);
 
     // Getters and Setters
     glm::vec3 getPosition() const { return position; }
@@ -127,67 +175,40 @@ public:
     void setColor(const glm::vec4& c) { this->color = c; } 
 };
 
-// Constructor: Initializes OpenGL IDs to 0, sets default position, scale, and color.
-GameObject::GameObject() : VAO(0), VBO(0), textureID(0), position(0.0f), scale(1.0f), color(1.0f) {}
+// Constructor: Sets default position, scale, and color; the mesh is picked by init().
+GameObject::GameObject() : m_mesh(nullptr), textureID(0), position(0.0f), scale(1.0f), color(1.0f) {}
 
-// Destructor: Cleans up OpenGL resources (buffers, arrays, arrays).
+// Destructor: Cleans up the object's texture (the mesh is shared and belongs to the MeshRegistry).
 GameObject::~GameObject() {
-    if (VBO != 0) {
-        glDeleteBuffers(1, &VBO);
-    }
-    if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
-    }
     // Note: textureID cleanup should be handled by the owning class if it's shared/managed,
     // or if a specific texture belongs only to this GameObject.
     // For now, assume a texture is unique to an object if loaded via loadTexture().
-    if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
-    }
+    deleteTextureUtility(textureID);
 }
 
-void GameObject::init() {
-    // Default quad vertices for any 2D GameObject.
-    // Format: Position (x,y,z), Normal (x,y,z), TexCoord (s,t)
-    vertices = {
-        // positions       // normals     // texture coords
-        -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, // bottom-left
-         0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, // bottom-right
-         0.5f,  0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, // top-right
-
-         0.5f,  0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, // top-right
-        -0.5f,  0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, // top-left
-        -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f  // bottom-left
-    };
-    setupMesh(); // Call setupMesh to initialize VAO/VBO with these vertices
+// Move constructor: Takes over the texture, the moved-from object no longer deletes it.
+GameObject::GameObject(GameObject&& other) noexcept
+    : m_mesh(other.m_mesh), position(other.position), scale(other.scale), color(other.color), textureID(other.textureID) {
+    other.textureID = 0;
 }
 
-// Sets up the VAO and VBO for the object's mesh.
-void GameObject::setupMesh() {
-    // If VAO/VBO already exist (e.g. for scoreDigitQuad which is reused), delete them first
-    if (VBO != 0) glDeleteBuffers(1, &VBO);
-    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
-
-    glGenVertexArrays(1, &VAO); // Generate VAO
-    glGenBuffers(1, &VBO);      // Generate VBO
-
-    glBindVertexArray(VAO);             // Bind VAO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO); // Bind VBO
-    // Upload vertex data to VBO
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
-
-    // Define vertex attribute pointers for the shader
-    // Layout 0: Position (3 floats)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Layout 1: Normal (3 floats) - even for 2D, included in vertex data
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // Layout 2: Texture Coordinate (2 floats)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+// Move assignment: Releases this object's texture, then takes over the other's.
+GameObject& GameObject::operator=(GameObject&& other) noexcept {
+    if (this != &other) {
+        deleteTextureUtility(textureID);
+        m_mesh = other.m_mesh;
+        position = other.position;
+        scale = other.scale;
+        color = other.color;
+        textureID = other.textureID;
+        other.textureID = 0;
+    }
+    return *this;
+}
 
-    glBindVertexArray(0); // Unbind VAO
+// Every plain GameObject is a textured quad (score digits, messages).
+void GameObject::init() {
+    m_mesh = &meshRegistry().get(MESH_UNIT_QUAD);
 }
 
 // Loads a texture for the object using the global utility function.
@@ -196,26 +217,21 @@ void GameObject::loadTexture(const char* path) {
 }
 
 // Draws the game object.
-void GameObject::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
-    if (VAO == 0) { 
+void GameObject::draw(GLuint shaderProgram) {
+    if (m_mesh == nullptr || m_mesh->VAO == 0) {
         std::cerr << "Attempted to draw GameObject with uninitialized VAO!" << std::endl;
         return;
     }
 
     glUseProgram(shaderProgram); // Use the specified shader program
 
-    // Pass model, view, and projection matrices to the shader
+    // Pass the model matrix to the shader (view and projection are already set on the program)
     unsigned int modelLoc = glGetUniformLocation(shaderProgram, "model");
     glm::mat4 modelMatrix = glm::mat4(1.0f);
     modelMatrix = glm::translate(modelMatrix, position);    // Apply translation
     modelMatrix = glm::scale(modelMatrix, scale);           // Apply scaling
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
 
-    unsigned int viewLoc = glGetUniformLocation(shaderProgram, "view");
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    unsigned int projLoc = glGetUniformLocation(shaderProgram, "projection");
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
     // Pass object color and texture usage flag to the shader
     unsigned int objColorLoc = glGetUniformLocation(shaderProgram, "objectColor");
     glUniform4fv(objColorLoc, 1, glm::value_ptr(color));
@@ -232,9 +248,9 @@ void GameObject::draw(GLuint shaderProgram, const glm::mat4& view, const glm::ma
         glUniform1i(useTextureLoc, 0);              // Tell shader not to use texture
     }
 
-    glBindVertexArray(VAO);                             // Bind the object's VAO
-    glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 8); // Draw the triangles
-    glBindVertexArray(0);                               // Unbind VAO
+    glBindVertexArray(m_mesh->VAO);                             // Bind the shared mesh
+    glDrawArrays(m_mesh->mode, 0, m_mesh->vertexCount);         // Draw the triangles
+    glBindVertexArray(0);                                       // Unbind VAO
 
     // Unbind texture after drawing to avoid unintended state changes
     if (textureID != 0) {
@@ -244,7 +260,7 @@ void GameObject::draw(GLuint shaderProgram, const glm::mat4& view, const glm::ma
 
 
 // Basket class (inherits from GameObject)
-class Basket : public GameObject {
+class Basket final : public GameObject {
 private:
     ElementType currentType; // Current element type of the basket
     float speed;             // Movement speed of the basket
@@ -253,9 +269,8 @@ private:
 public:
     Basket(float x, float y, float w, float h, float s);
 
-    void init() override;
-    void update(float deltaTime, Game* gameInstance = nullptr) override; // Keep signature consistent
-    void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) override;
+    void init();
+    void draw(GLuint shaderProgram);
 
     void moveLeft(float deltaTime);     // Move Left
     void moveRight(float deltaTime);    // Move Right
@@ -282,12 +297,12 @@ Basket::Basket(float x, float y, float w, float h, float s)
 
 // Initializes the basket's mesh and loads its texture.
 void Basket::init() {
-    GameObject::init();                 // Call base class init to setup VAO/VBO
+    GameObject::init();                 // Call base class init to pick the shared quad mesh
     loadTexture("textures/basket.png"); // Load the basket texture
 }
 
 // Draws the basket, setting its color based on its current element type.
-void Basket::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
+void Basket::draw(GLuint shaderProgram) {
     // Set the color based on the currentType to tint the basket texture
     switch (currentType) {
     case EARTH: setColor(glm::vec4(0.6f, 0.4f, 0.2f, 1.0f)); break; // Brown for Earth
@@ -297,7 +312,7 @@ void Basket::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4&
     default:    setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); break; // Default white (no tint)
     }
 
-    GameObject::draw(shaderProgram, view, projection); // Call base class draw method
+    GameObject::draw(shaderProgram); // Call base class draw method
 }
 
 // Moves the basket left.
@@ -318,7 +333,7 @@ void Basket::changeType(int direction) {
 
 
 // Orb class (inherits from GameObject)
-class Orb : public GameObject {
+class Orb final : public GameObject {
 private:
     ElementType type;               // Element type of the orb
     float fallSpeed;                // Speed at which the orb falls
@@ -333,11 +348,11 @@ private:
     float m_particleEmitInterval;   // How often to emit particles
 
 public:
-    Orb(float x, float y, float w, float h, ElementType t, float speed);
+    Orb(float x, float y, float w, float h, ElementType t, float speed, std::mt19937& rng); // rng picks the zig-zag
 
-    void init() override;
-    void update(float deltaTime, Game* gameInstance) override;
-    void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) override;
+    void init();
+    void update(float deltaTime, Game* gameInstance);
+    void draw(GLuint shaderProgram);
 
     ElementType getType() const { return type; }
     // Checks if the orb is off-screen (below the given Y coordinate).
@@ -351,7 +366,7 @@ public:
 };
 
 // Orb constructor: Sets up initial position, scale, type, and fall speed.
-Orb::Orb(float x, float y, float w, float h, ElementType t, float speed)
+Orb::Orb(float x, float y, float w, float h, ElementType t, float speed, std::mt19937& rng)
     : type(t), fallSpeed(speed), width(w), height(h),
     m_particleEmitTimer(0.0f), m_particleEmitInterval(0.05f)
 {
@@ -359,91 +374,38 @@ Orb::Orb(float x, float y, float w, float h, ElementType t, float speed)
     scale = glm::vec3(w, h, 1.0f);
 
     m_initialX = x; // Store the original spawn X position
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_real_distribution<float> ampDist(20.0f, 60.0f);        // Amplitude units
     std::uniform_real_distribution<float> freqDist(0.8f, 5.0f);         // Frequency oscillations per second
     std::uniform_real_distribution<float> phaseDist(0.0f, 4.0f * M_PI); // Random phase offset for variety
 
-    m_zigzagAmplitude = ampDist(gen);
-    m_zigzagFrequency = freqDist(gen);
-    m_zigzagPhaseOffset = phaseDist(gen);
+    m_zigzagAmplitude = ampDist(rng);
+    m_zigzagFrequency = freqDist(rng);
+    m_zigzagPhaseOffset = phaseDist(rng);
 }
 
-// Initializes the orb's mesh and loads its specific element texture.
-void Orb::init() {
-    const int numSegments = 30; // Number of segments to approximate the circle
-    const float radius = 0.5f;  // Orb's quad is -0.5 to 0.5, so radius is 0.5 to fit in the scale.
-
-    // Clear existing vertices
-    vertices.clear();
-
-    // Center vertex (for a fan-like triangulation)
-    // Position (x,y,z), Normal (x,y,z), TexCoord (s,t)
-    vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(0.0f);   // Center position
-    vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(1.0f);   // Normal (facing camera)
-    vertices.push_back(0.5f); vertices.push_back(0.5f);                             // Center of texture
-
-    for (int i = 0; i <= numSegments; ++i) {
-        float angle = 2.0f * M_PI * static_cast<float>(i) / static_cast<float>(numSegments);
-        float x = radius * cos(angle);
-        float y = radius * sin(angle);
-
-        // Position
-        vertices.push_back(x); vertices.push_back(y); vertices.push_back(0.0f);
-        // Normal (facing camera)
-        vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(1.0f);
-        // Texture Coordinates (map to a circle on the texture)
-        vertices.push_back((x / (2.0f * radius)) + 0.5f); // Normalize x to 0-1 range and shift
-        vertices.push_back((y / (2.0f * radius)) + 0.5f); // Normalize y to 0-1 range and shift
-    }
-
-    setupMesh(); 
-
-    // Generate vertices for triangles
-    vertices.clear();
-    for (int i = 0; i < numSegments; ++i) {
-        float angle1 = 2.0f * M_PI * static_cast<float>(i) / static_cast<float>(numSegments);
-        float angle2 = 2.0f * M_PI * static_cast<float>(i + 1) / static_cast<float>(numSegments);
-
-        // Triangle 1: Center vertex
-        vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(0.0f);   // Pos
-        vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(1.0f);   // Normal
-        vertices.push_back(0.5f); vertices.push_back(0.5f);                             // TexCoord (center)
-
-        // Triangle 2: First point on circumference
-        float x1 = radius * cos(angle1);
-        float y1 = radius * sin(angle1);
-        vertices.push_back(x1); vertices.push_back(y1); vertices.push_back(0.0f);                               // Pos
-        vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(1.0f);                           // Normal
-        vertices.push_back((x1 / (2.0f * radius)) + 0.5f); vertices.push_back((y1 / (2.0f * radius)) + 0.5f);   // TexCoord
-
-        // Triangle 3: Second point on circumference
-        float x2 = radius * cos(angle2);
-        float y2 = radius * sin(angle2);
-        vertices.push_back(x2); vertices.push_back(y2); vertices.push_back(0.0f);                               // Pos
-        vertices.push_back(0.0f); vertices.push_back(0.0f); vertices.push_back(1.0f);                           // Normal
-        vertices.push_back((x2 / (2.0f * radius)) + 0.5f); vertices.push_back((y2 / (2.0f * radius)) + 0.5f);   // TexCoord
-    }
-
-    setupMesh(); // Call base class setupMesh to initialize VAO/VBO with these vertices
-
-    std::string texturePath;
+// Texture of each element's orb (its alpha channel is also the orb's collision mask).
+static const char* orbTexturePath(ElementType type) {
     switch (type) {
-    case EARTH: texturePath = "textures/earth_orb.png"; break;
-    case WATER: texturePath = "textures/water_orb.png"; break;
-    case FIRE:  texturePath = "textures/fire_orb.png";  break;
-    case AIR:   texturePath = "textures/air_orb.png";   break;
-    default:    texturePath = "textures/default_orb.png"; break; // Fallback texture (doesn't exist, shhh don't tell anyone)
+    case EARTH: return "textures/earth_orb.png";
+    case WATER: return "textures/water_orb.png";
+    case FIRE:  return "textures/fire_orb.png";
+    case AIR:   return "textures/air_orb.png";
+    default:    return "textures/default_orb.png"; // Fallback texture (doesn't exist, shhh don't tell anyone)
     }
-    loadTexture(texturePath.c_str());
+}
+
+// Initializes the orb's mesh and loads its specific element texture.
+void Orb::init() {
+    m_mesh = &meshRegistry().get(MESH_UNIT_CIRCLE); // Shared circle fan, radius 0.5 to fit in the scale
+
+    loadTexture(orbTexturePath(type));
 }
 
 // Draws the orb, setting its color (usually white to show full texture color).
-void Orb::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
+void Orb::draw(GLuint shaderProgram) {
     // Orbs primarily use their texture, so set color to white for no tinting.
     setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-    GameObject::draw(shaderProgram, view, projection); // Call base class draw method
+    GameObject::draw(shaderProgram); // Call base class draw method
 }
 
 
@@ -470,6 +432,7 @@ private:
     GLuint particleVAO, particleVBO, particleInstanceVBO;   // OpenGL IDs for rendering
     std::string particleTexturePath;                        // Path to the particle's texture
     GLuint textureID;                                       // OpenGL texture ID for particles
+    int activeParticles;                                    // Particles alive after the last update
 
     // Vertices for a single 2D quad that will be instanced for each particle
     std::vector<float> quadVertices = {
@@ -484,23 +447,33 @@ private:
         2, 3, 0     // Second triangle
     };
     GLuint quadEBO; // Element Buffer Object for the quad indices
+    MemorySubsystem memorySubsystem;                        // Where the pool is accounted in the memory report
+    double trackedCpuBytes, trackedGpuBytes;                // What this system added to the memory report
+    std::mt19937 rng;                                       // Velocity, lifetime and size of emitted particles
 
     unsigned int findUnusedParticle(); // Finds an inactive particle to reuse
 
 public:
-    ParticleSystem(int maxParticles, const std::string& texturePath = "");
+    ParticleSystem(int maxParticles, MemorySubsystem memorySubsystem, const std::string& texturePath = "");
     ~ParticleSystem();
 
     void init(); // Initializes OpenGL resources for the particle system
     void update(float deltaTime, const glm::vec3& cameraPos); // Updates all active particles
-    void draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection); // Draws all active particles
+    void draw(GLuint shaderProgram); // Draws all active particles
     void emit(const glm::vec3& position, int count, ElementType type); // Emits new particles at a given position
+    int getActiveCount() const { return activeParticles; }
+    void seed(uint32_t value) { rng.seed(value); }
 };
 
 // ParticleSystem constructor: Resizes the particle pool and stores texture path.
-ParticleSystem::ParticleSystem(int maxParticles, const std::string& texturePath)
-    : maxParticles(maxParticles), lastUsedParticle(0), particleTexturePath(texturePath), textureID(0) {
+ParticleSystem::ParticleSystem(int maxParticles, MemorySubsystem memorySubsystem, const std::string& texturePath)
+    : maxParticles(maxParticles), lastUsedParticle(0), particleTexturePath(texturePath), textureID(0), activeParticles(0),
+    memorySubsystem(memorySubsystem), trackedCpuBytes(0.0), trackedGpuBytes(0.0) {
     particles.resize(maxParticles);
+
+    trackedCpuBytes = sizeof(ParticleSystem) + particles.capacity() * sizeof(Particle)
+        + quadVertices.capacity() * sizeof(float) + quadIndices.capacity() * sizeof(unsigned int);
+    memoryAdd(memorySubsystem, trackedCpuBytes, 0.0);
 }
 
 // ParticleSystem destructor: Cleans up OpenGL resources.
@@ -509,7 +482,8 @@ ParticleSystem::~ParticleSystem() {
     if (quadEBO != 0) glDeleteBuffers(1, &quadEBO);
     if (particleVBO != 0) glDeleteBuffers(1, &particleVBO);
     if (particleVAO != 0) glDeleteVertexArrays(1, &particleVAO);
-    if (textureID != 0) glDeleteTextures(1, &textureID);
+    deleteTextureUtility(textureID);
+    memoryAdd(memorySubsystem, -trackedCpuBytes, -trackedGpuBytes);
 }
 
 // Initializes OpenGL buffers and attributes for instanced particle rendering.
@@ -539,6 +513,9 @@ void ParticleSystem::init() {
     glBindBuffer(GL_ARRAY_BUFFER, particleInstanceVBO);
     // Allocate buffer for instance data: position (3), normalized life (1), color (4), size (1) = 9 floats per particle
     glBufferData(GL_ARRAY_BUFFER, maxParticles * (3 + 1 + 4 + 1) * sizeof(float), NULL, GL_STREAM_DRAW); // GL_STREAM_DRAW for frequent updates
+    trackedGpuBytes = quadVertices.size() * sizeof(float) + quadIndices.size() * sizeof(unsigned int)
+        + maxParticles * (3 + 1 + 4 + 1) * sizeof(float);
+    memoryAdd(memorySubsystem, 0.0, trackedGpuBytes);
 
     // Layout 2: instancePosition (position of the particle in world space)
     glEnableVertexAttribArray(2);
@@ -562,6 +539,12 @@ void ParticleSystem::init() {
 
     glBindVertexArray(0); // Unbind VAO
 
+    std::string label = "ParticleSystem " + particleTexturePath;
+    glDebugLabel(GL_VERTEX_ARRAY, particleVAO, (label + " VAO").c_str());
+    glDebugLabel(GL_BUFFER, particleVBO, (label + " quad VBO").c_str());
+    glDebugLabel(GL_BUFFER, quadEBO, (label + " quad EBO").c_str());
+    glDebugLabel(GL_BUFFER, particleInstanceVBO, (label + " instance VBO").c_str());
+
     if (!particleTexturePath.empty()) {
         textureID = loadTextureUtility(particleTexturePath.c_str()); // Load particle texture
     }
@@ -588,8 +571,6 @@ unsigned int ParticleSystem::findUnusedParticle() {
 
 // Emits a specified number of particles at a given position with type-specific properties.
 void ParticleSystem::emit(const glm::vec3& position, int count, ElementType type) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
     std::uniform_real_distribution<float> velDist(-1.0f, 1.0f); // For random velocity components
     std::uniform_real_distribution<float> lifeDist(0.5f, 1.5f);  // For random particle lifetime
     std::uniform_real_distribution<float> sizeDist(15.0f, 25.0f); // For random particle size
@@ -600,28 +581,28 @@ void ParticleSystem::emit(const glm::vec3& position, int count, ElementType type
             Particle& p = particles[particleIdx];
             p.active = true;
             p.position = position; // Start at the emission point
-            p.duration = lifeDist(gen); // Random duration
+            p.duration = lifeDist(rng); // Random duration
             p.life = 0.0f; // Reset current life
-            p.size = sizeDist(gen); // Random initial size
+            p.size = sizeDist(rng); // Random initial size
 
             // Set specific colors and initial velocities based on element type
             switch (type) {
             case EARTH:
                 p.color = glm::vec4(0.4f, 0.2f, 0.0f, 1.0f); // Dark brown
-                p.velocity = glm::vec3(velDist(gen) * 30.0f, velDist(gen) * 30.0f - 20.0f, 0.0f); // Slightly downward bias
+                p.velocity = glm::vec3(velDist(rng) * 30.0f, velDist(rng) * 30.0f - 20.0f, 0.0f); // Slightly downward bias
                 break;
             case WATER:
                 p.color = glm::vec4(0.5f, 0.7f, 1.0f, 1.0f); // Light blue
-                p.velocity = glm::vec3(velDist(gen) * 40.0f, velDist(gen) * 40.0f + 10.0f, 0.0f); // Slightly upward bias
+                p.velocity = glm::vec3(velDist(rng) * 40.0f, velDist(rng) * 40.0f + 10.0f, 0.0f); // Slightly upward bias
                 break;
             case FIRE:
                 p.color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f); // Orange/Yellow
-                p.velocity = glm::vec3(velDist(gen) * 60.0f, fabs(velDist(gen)) * 80.0f + 20.0f, 0.0f); // Strong upward bias
+                p.velocity = glm::vec3(velDist(rng) * 60.0f, fabs(velDist(rng)) * 80.0f + 20.0f, 0.0f); // Strong upward bias
                 break;
             case AIR:
                 p.color = glm::vec4(0.8f, 0.9f, 1.0f, 1.0f); // Very light blue/white
-                p.velocity = glm::vec3(velDist(gen) * 70.0f, velDist(gen) * 70.0f, 0.0f); // More spread out, higher speed
-                p.size = sizeDist(gen) * 1.2f; // Slightly larger for air
+                p.velocity = glm::vec3(velDist(rng) * 70.0f, velDist(rng) * 70.0f, 0.0f); // More spread out, higher speed
+                p.size = sizeDist(rng) * 1.2f; // Slightly larger for air
                 break;
             default:
                 p.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f); // Default white
@@ -633,6 +614,7 @@ void ParticleSystem::emit(const glm::vec3& position, int count, ElementType type
 
 // Updates the state of all active particles.
 void ParticleSystem::update(float deltaTime, const glm::vec3& cameraPos) {
+    activeParticles = 0;
     for (auto& p : particles) {
         if (p.active) {
             p.life += deltaTime; // Advance particle's life
@@ -642,17 +624,20 @@ void ParticleSystem::update(float deltaTime, const glm::vec3& cameraPos) {
             else {
                 p.position += p.velocity * deltaTime; // Update position based on velocity
                 p.velocity *= (1.0f - 0.5f * deltaTime); // Apply simple friction/drag (adjust 0.5f for effect)
+                activeParticles++;
             }
         }
     }
 }
 
 // Draws all active particles using instanced rendering.
-void ParticleSystem::draw(GLuint shaderProgram, const glm::mat4& view, const glm::mat4& projection) {
+void ParticleSystem::draw(GLuint shaderProgram) {
+    PROFILE_SCOPE("ParticleSystem::draw");
     glUseProgram(shaderProgram); // Use the particle shader
 
-    // Prepare instance data for active particles
-    std::vector<float> instanceData;
+    // Prepare instance data for active particles, in frame memory sized for what update() left alive
+    FrameVector<float> instanceData{ FrameAllocator<float>(frameArena()) };
+    instanceData.reserve(activeParticles * (3 + 1 + 4 + 1));
     int numActiveParticles = 0;
     for (const auto& p : particles) {
         if (p.active) {
@@ -679,9 +664,7 @@ void ParticleSystem::draw(GLuint shaderProgram, const glm::mat4& view, const glm
     glBufferSubData(GL_ARRAY_BUFFER, 0, instanceData.size() * sizeof(float), instanceData.data());
     glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind
 
-    // Pass view and projection matrices to the particle shader
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    // View and projection matrices are already set on the program by Game::draw
     // Pass current time for shader animations (if any)
     // glUniform1f(glGetUniformLocation(shaderProgram, "currentTime"), glfwGetTime()); // If you need a global time uniform
 
@@ -711,19 +694,30 @@ void ParticleSystem::draw(GLuint shaderProgram, const glm::mat4& view, const glm
 
 // Game class: Manages game state, objects, and logic.
 class Game {
+    friend class GameBenchmarks; // Benchmark cases drive private steps like checkCollisions directly
+
 private:
     int screenWidth, screenHeight; // Current dimensions of the game window
     int score;                     // Player's score
     std::unique_ptr<Basket> playerBasket; // The player's basket
-    std::vector<std::unique_ptr<Orb>> fallingOrbs; // List of active orbs
+    // Active orbs by value, oldest first. Every orb falls at orbFallSpeed from the top of the screen, so
+    // this is also lowest first: misses leave from the front and only a band near the front can touch the basket.
+    RingBuffer<Orb> fallingOrbs;
     std::vector<std::unique_ptr<ParticleSystem>> particleSystems; // One particle system for each element type
 
     float orbSpawnTimer;      // Timer for spawning new orbs
     float orbSpawnInterval;   // How often new orbs spawn
     float orbFallSpeed;       // Speed at which orbs fall
+    float orbSize;            // Width and height of every orb
     float basketBottomMargin; // Distance of the basket from the bottom edge
 
-    std::mt19937 rng; // Random number generator engine
+    std::mt19937 rng; // Random number generator engine, everything random in a session comes from it or the particle systems
+    uint32_t m_seed;  // What rng and the particle systems were seeded with, recorded with replays
+    double m_gameTime; // Seconds of simulation so far, drives the orbs' zig-zag
+    int m_pendingScroll; // Scroll steps received since the last processInput
+    KeyIntervals m_leftKey;  // When A went down and up, from the key callback
+    KeyIntervals m_rightKey; // Same for D
+    double m_lastInputTime;  // glfwGetTime() of the last processInput, the start of the tick being collected (negative before the first)
 
     // For Score Display
     std::vector<GLuint> m_digitTextures; // Stores texture IDs for digits 0-9
@@ -745,15 +739,24 @@ private:
     float m_restartMessageWidth = 300.0f; // Width for restart prompt
     float m_restartMessageHeight = 50.0f; // Height for restart prompt
 
-    ma_engine m_audioEngine;
-    ma_sound m_correctCatchSound;
-    ma_sound m_wrongCatchSound;
+    AudioSystem m_audio; // Sound effects, played on the audio thread through a command queue
+
+    GpuPassTimer m_passTimer; // CPU and GPU time of each render pass, published as metrics
+
+    unsigned int m_uploadedCameraVersion; // Camera version whose matrices the shader programs currently hold
+    void uploadCameraMatrices(GLuint gameShader, GLuint particleShader, const Camera& camera);
+    void drawScore(GLuint gameShader);      // Score HUD pass
+    void drawMessages(GLuint gameShader);   // Game over / win messages pass
 
 
     void spawnOrb();       // Creates and adds a new orb
     void checkCollisions(); // Checks for collisions between orbs and basket
     // Helper for Axis-Aligned Bounding Box (AABB) collision detection
     bool checkAABBCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2);
+    bool checkMaskCollision(const Orb& orb); // Pixel-accurate test for orbs that passed the AABB test
+
+    AlphaMask m_basketMask;                     // Opaque cells of basket.png at the basket's size
+    AlphaMask m_orbMasks[NUM_ELEMENT_TYPES];    // Opaque cells of each orb texture, clipped to the circle it is drawn on
 
     // Helper to get color based on element type
     glm::vec4 getOrbColor(ElementType type) const {
@@ -767,19 +770,27 @@ private:
     }
 
 public:
-    Game(int width, int height); // Constructor
+    Game(int width, int height, const char* audioWavPath = nullptr); // Constructor (a WAV path switches audio to offline rendering)
     ~Game();                     // Destructor
 
     void init(); // Initializes game objects and systems
     void update(float deltaTime, const glm::vec3& cameraPos); // Updates game logic
-    void draw(GLuint gameShader, GLuint particleShader, const glm::mat4& view, const glm::mat4& projection); // Draws game elements
-    void processInput(GLFWwindow* window, float deltaTime); // Handles player input
-    void scrollCallback(double yoffset); // Handles mouse scroll input for basket type change
+    void draw(GLuint gameShader, GLuint particleShader, const Camera& camera); // Draws game elements
+    InputFrame processInput(GLFWwindow* window, float deltaTime); // Reads and applies player input, returns it for recording
+    void applyInput(const InputFrame& input, float deltaTime); // Applies one tick of input (live or replayed)
+    void scrollCallback(double yoffset); // Queues mouse scroll input for basket type change
+    void keyCallback(int key, int action, double time); // Records when the movement keys go down and up
     void setScreenDimensions(int newWidth, int newHeight); // Updates game's internal screen dimensions
     void resetGame(); // Resets game to starting state
 
     int getScore() const { return score; } // Returns current score
+    void setSeed(uint32_t seed); // Makes the session reproducible: same seed and input, same game
+    uint32_t getSeed() const { return m_seed; }
+    std::mt19937& getRng() { return rng; }
+    double getGameTime() const { return m_gameTime; }
     GameState getCurrentState() const { return m_currentState; } // Returns current game state
+    bool isIdle() const; // Game over and the last particles have died: nothing on screen moves until input arrives
+    uint64_t renderSignature() const; // Hash of everything draw() shows; equal signatures draw identical frames
 
     // New getter to allow Orbs to access their specific particle system
     ParticleSystem* getParticleSystem(ElementType type) {
@@ -791,13 +802,14 @@ public:
 };
 
 // Game constructor: Initializes game state and objects.
-Game::Game(int width, int height)
+Game::Game(int width, int height, const char* audioWavPath)
     : screenWidth(width), screenHeight(height), score(0),
-    orbSpawnTimer(0.0f), orbSpawnInterval(1.5f), orbFallSpeed(100.0f),
+    orbSpawnTimer(0.0f), orbSpawnInterval(1.5f), orbFallSpeed(100.0f), orbSize(60.0f),
     basketBottomMargin(30.0f), // Initial margin from the very bottom of the window
-    rng(std::random_device{}()), // Initialize random number generator
+    m_gameTime(0.0), m_pendingScroll(0), m_lastInputTime(-1.0),
     m_lastDestroyedOrbColor(1.0f, 1.0f, 1.0f, 1.0f),
-    m_currentState(GameState::RUNNING) // Initialize game state
+    m_currentState(GameState::RUNNING), // Initialize game state
+    m_uploadedCameraVersion(static_cast<unsigned int>(-1)) // No camera uploaded yet
 {
     // Initialize basket: centered horizontally, at the bottom of the screen (using new centered coords)
     // Y: bottom edge (-screenHeight/2) + half basket height + margin
@@ -812,17 +824,17 @@ Game::Game(int width, int height)
 
     // Initialize particle systems (one for each element type)
     particleSystems.resize(NUM_ELEMENT_TYPES);
-    particleSystems[EARTH] = std::make_unique<ParticleSystem>(500, "textures/earth_particle.png");
-    particleSystems[WATER] = std::make_unique<ParticleSystem>(500, "textures/water_particle.png");
-    particleSystems[FIRE] = std::make_unique<ParticleSystem>(500, "textures/fire_particle.png");
-    particleSystems[AIR] = std::make_unique<ParticleSystem>(500, "textures/air_particle.png");
-
-    ma_result result = ma_engine_init(NULL, &m_audioEngine);
-    if (result != MA_SUCCESS) {
-        std::cerr << "Failed to initialize audio engine." << std::endl;
+    particleSystems[EARTH] = std::make_unique<ParticleSystem>(500, MEMORY_PARTICLES_EARTH, "textures/earth_particle.png");
+    particleSystems[WATER] = std::make_unique<ParticleSystem>(500, MEMORY_PARTICLES_WATER, "textures/water_particle.png");
+    particleSystems[FIRE] = std::make_unique<ParticleSystem>(500, MEMORY_PARTICLES_FIRE, "textures/fire_particle.png");
+    particleSystems[AIR] = std::make_unique<ParticleSystem>(500, MEMORY_PARTICLES_AIR, "textures/air_particle.png");
+    setSeed(std::random_device{}());
+
+    if (audioWavPath != nullptr) {
+        m_audio.initOffline(audioWavPath); // No sound device, mixed audio goes to a file in lockstep with update()
     }
     else {
-        std::cout << "Audio engine initialized." << std::endl;
+        m_audio.init();
     }
 }
 
@@ -830,25 +842,19 @@ Game::Game(int width, int height)
 Game::~Game() {
     // m_digitTextures are raw GLuints, must be deleted manually
     for (GLuint texID : m_digitTextures) {
-        if (texID != 0) {
-            glDeleteTextures(1, &texID);
-        }
+        deleteTextureUtility(texID);
     }
-    if (m_minusTexture != 0) glDeleteTextures(1, &m_minusTexture); 
-    if (m_gameOverTextureID != 0) glDeleteTextures(1, &m_gameOverTextureID);
-    if (m_youWinTextureID != 0) glDeleteTextures(1, &m_youWinTextureID);
-    if (m_pressRToRestartTextureID != 0) glDeleteTextures(1, &m_pressRToRestartTextureID);
-
-    // m_scoreDigitQuad and m_messageQuad are GameObjects, their destructors will clean up their VAO/VBO.
-    // playerBasket, fallingOrbs, particleSystems are unique_ptrs, they self-delete.
-
-
-    ma_sound_uninit(&m_correctCatchSound);
-
-    ma_sound_uninit(&m_wrongCatchSound);
-
-    ma_engine_uninit(&m_audioEngine);
-    std::cout << "Audio engine uninitialized." << std::endl;
+    deleteTextureUtility(m_minusTexture);
+    deleteTextureUtility(m_gameOverTextureID);
+    deleteTextureUtility(m_youWinTextureID);
+    deleteTextureUtility(m_pressRToRestartTextureID);
+    // The HUD quads only borrow those textures, so their destructors must not delete them again
+    m_scoreDigitQuad.textureID = 0;
+    m_messageQuad.textureID = 0;
+
+    // playerBasket and particleSystems are unique_ptrs and fallingOrbs holds its orbs by value: they all
+    // clean up in their own destructors, each object deleting the texture it loaded.
+    // m_audio stops its audio thread and releases its sounds in its own destructor.
 }
 
 // Initializes all game objects and particle systems.
@@ -884,63 +890,78 @@ void Game::init() {
     m_youWinTextureID = loadTextureUtility("textures/you_win.png");
     m_pressRToRestartTextureID = loadTextureUtility("textures/press_r_to_restart.png");
 
-    ma_result result;
-
-    result = ma_sound_init_from_file(&m_audioEngine, "sounds/correct_catch.wav", MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, NULL, NULL, &m_correctCatchSound);
-    if (result != MA_SUCCESS) {
-        std::cerr << "Failed to load correct catch sound: " << result << std::endl;
-    }
-    else {
-        ma_sound_set_volume(&m_correctCatchSound, 0.5f); // Adjust volume if needed
-        std::cout << "Correct catch sound loaded." << std::endl;
+    // Collision masks at the size the sprites are drawn, one simulation unit per cell
+    m_basketMask.load("textures/basket.png", static_cast<int>(playerBasket->getScale().x), static_cast<int>(playerBasket->getScale().y));
+    for (int type = 0; type < NUM_ELEMENT_TYPES; ++type) {
+        m_orbMasks[type].load(orbTexturePath(static_cast<ElementType>(type)), static_cast<int>(orbSize), static_cast<int>(orbSize));
+        m_orbMasks[type].clipToEllipse();
     }
 
-    result = ma_sound_init_from_file(&m_audioEngine, "sounds/wrong_catch.wav", MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, NULL, NULL, &m_wrongCatchSound);
-    if (result != MA_SUCCESS) {
-        std::cerr << "Failed to load wrong catch sound: " << result << std::endl;
+    m_audio.loadSound(SOUND_CORRECT_CATCH, "sounds/correct_catch.wav", 0.5f); // Adjust volume if needed
+    m_audio.loadSound(SOUND_WRONG_CATCH, "sounds/wrong_catch.wav", 0.5f);     // Adjust volume if needed
+    // Background music is optional: drop a track at this path to get it, streamed from disk (FLAC, MP3 or WAV)
+    const char* musicPath = "sounds/music.mp3";
+    if (FILE* music = fopen(musicPath, "rb")) {
+        fclose(music);
+        m_audio.playMusic(musicPath, 0.3f);
     }
     else {
-        ma_sound_set_volume(&m_wrongCatchSound, 0.5f); // Adjust volume if needed
-        std::cout << "Wrong catch sound loaded." << std::endl;
+        std::cout << "No background music (" << musicPath << " not found)." << std::endl;
     }
+
+    m_passTimer.init();
 }
 
 // Updates game logic for all elements.
 void Game::update(float deltaTime, const glm::vec3& cameraPos) {
+    PROFILE_SCOPE("Game::update");
+    ALLOC_SCOPE("Game::update");
+    m_gameTime += deltaTime;
+
     if (m_currentState == GameState::RUNNING) {
         // Update falling orbs
-        for (auto& orb : fallingOrbs) {
-            orb->update(deltaTime, this); // Pass 'this' (pointer to the Game instance)
+        {
+            PROFILE_SCOPE("updateOrbs");
+            for (Orb& orb : fallingOrbs) {
+                orb.update(deltaTime, this); // Pass 'this' (pointer to the Game instance)
+            }
         }
 
         // Remove off-screen orbs and apply penalty
-        fallingOrbs.erase(std::remove_if(fallingOrbs.begin(), fallingOrbs.end(),
-            [this](const std::unique_ptr<Orb>& orb) {
-                // Orb is off-screen if its bottom edge is below the screen's bottom edge (-screenHeight/2)
-                if (orb->isOffScreen(-(static_cast<float>(screenHeight) / 2.0f))) {
-                    score -= 2; // Penalty for missing an orb
-                    m_lastDestroyedOrbColor = getOrbColor(orb->getType()); // Update last destroyed orb color
-                    std::cout << "Orb missed! Score: " << score << std::endl;
-                    ma_sound_start(&m_wrongCatchSound); // Play wrong sound for missed orb
-                    return true; // Remove this orb
-                }
-                return false;
-            }),
-            fallingOrbs.end());
+        {
+            PROFILE_SCOPE("removeOffScreenOrbs");
+            // Orb is off-screen if its bottom edge is below the screen's bottom edge (-screenHeight/2).
+            // The lowest orbs are at the front, so misses are popped from there until one is still on screen.
+            while (!fallingOrbs.empty() && fallingOrbs.front().isOffScreen(-(static_cast<float>(screenHeight) / 2.0f))) {
+                const Orb& orb = fallingOrbs.front();
+                score -= 2; // Penalty for missing an orb
+                m_lastDestroyedOrbColor = getOrbColor(orb.getType()); // Update last destroyed orb color
+                std::cout << "Orb missed! Score: " << score << std::endl;
+                m_audio.trigger(SOUND_WRONG_CATCH); // Play wrong sound for missed orb
+                fallingOrbs.pop_front(); // Remove this orb
+            }
+        }
 
         // Spawn new orbs based on timer
-        orbSpawnTimer += deltaTime;
-        if (orbSpawnTimer >= orbSpawnInterval) {
-            spawnOrb();
-            orbSpawnTimer = 0.0f;
+        {
+            PROFILE_SCOPE("spawnOrbs");
+            orbSpawnTimer += deltaTime;
+            if (orbSpawnTimer >= orbSpawnInterval) {
+                ALLOC_SCOPE_EXEMPT("spawnOrb"); // Orb::init loads its texture from disk every interval (and fallingOrbs may grow), accepted until textures are shared
+                spawnOrb();
+                orbSpawnTimer = 0.0f;
+            }
         }
 
         // Check for collisions between orbs and basket
         checkCollisions();
 
         // Update all particle systems
-        for (auto& ps : particleSystems) {
-            ps->update(deltaTime, cameraPos);
+        {
+            PROFILE_SCOPE("updateParticles");
+            for (auto& ps : particleSystems) {
+                ps->update(deltaTime, cameraPos);
+            }
         }
 
         if (score <= -5) { // if score drops below -5
@@ -953,35 +974,136 @@ void Game::update(float deltaTime, const glm::vec3& cameraPos) {
             fallingOrbs.clear(); // Clear all existing orbs
             std::cout << "You Win!" << std::endl;
         }
-
     }
     else { // Game is in GAME_OVER state
+        PROFILE_SCOPE("updateParticles");
         for (auto& ps : particleSystems) {
             ps->update(deltaTime, cameraPos);
         }
     }
+
+    // Live counts for the performance overlay, and their high-water marks
+    metricAdd(METRIC_TICKS, 1);
+    metricSet(METRIC_LIVE_ORBS, static_cast<double>(fallingOrbs.size()));
+    metricMax(METRIC_ORBS_HIGH_WATER, static_cast<double>(fallingOrbs.size()));
+    for (int type = 0; type < NUM_ELEMENT_TYPES; ++type) {
+        metricSet(static_cast<MetricID>(METRIC_LIVE_PARTICLES_EARTH + type), particleSystems[type]->getActiveCount());
+        metricMax(static_cast<MetricID>(METRIC_PARTICLES_HIGH_WATER_EARTH + type), particleSystems[type]->getActiveCount());
+    }
+
+    // Orbs come and go every few seconds, so their memory is recounted rather than tracked per orb
+    // (the circle mesh they share is counted once, under meshes)
+    memorySet(MEMORY_ORBS, static_cast<double>(fallingOrbs.capacity() * sizeof(Orb)), 0.0);
+
+    {
+        PROFILE_SCOPE("audio");
+        // Send this tick's sound triggers to the audio thread (identical ones are merged)
+        m_audio.flush();
+        // When rendering audio offline, mix exactly this tick's worth of samples
+        m_audio.advance(deltaTime);
+    }
+}
+
+bool Game::isIdle() const {
+    if (m_currentState == GameState::RUNNING) return false;
+    for (const auto& ps : particleSystems) {
+        if (ps->getActiveCount() > 0) return false;
+    }
+    return true;
+}
+
+// Covers the basket, the orbs, the score and its colour, and the state (which picks the messages).
+// Live particles move every tick, so while any are alive the game time goes in as well.
+uint64_t Game::renderSignature() const {
+    uint64_t hash = HASH_SEED;
+    hash = hashBytes(hash, &m_currentState, sizeof(m_currentState));
+    hash = hashBytes(hash, &score, sizeof(score));
+    hash = hashBytes(hash, &m_lastDestroyedOrbColor, sizeof(m_lastDestroyedOrbColor));
+    hash = hashBytes(hash, &screenWidth, sizeof(screenWidth));
+    hash = hashBytes(hash, &screenHeight, sizeof(screenHeight));
+
+    ElementType basketType = playerBasket->getType();
+    glm::vec3 basketPosition = playerBasket->getPosition();
+    glm::vec3 basketScale = playerBasket->getScale();
+    hash = hashBytes(hash, &basketType, sizeof(basketType));
+    hash = hashBytes(hash, &basketPosition, sizeof(basketPosition));
+    hash = hashBytes(hash, &basketScale, sizeof(basketScale));
+
+    size_t orbCount = fallingOrbs.size();
+    hash = hashBytes(hash, &orbCount, sizeof(orbCount));
+    for (const Orb& orb : fallingOrbs) {
+        ElementType orbType = orb.getType();
+        glm::vec3 orbPosition = orb.getPosition();
+        hash = hashBytes(hash, &orbType, sizeof(orbType));
+        hash = hashBytes(hash, &orbPosition, sizeof(orbPosition));
+    }
+
+    for (const auto& ps : particleSystems) {
+        if (ps->getActiveCount() > 0) {
+            hash = hashBytes(hash, &m_gameTime, sizeof(m_gameTime));
+            break;
+        }
+    }
+    return hash;
+}
+
+// Sets the view and projection uniforms on both programs. Uniforms are stored per program,
+// so this only has to happen when the camera changed, not for every object drawn.
+void Game::uploadCameraMatrices(GLuint gameShader, GLuint particleShader, const Camera& camera) {
+    if (camera.getVersion() == m_uploadedCameraVersion) return; // Nothing changed since the last upload
+
+    const GLuint programs[2] = { gameShader, particleShader };
+    for (GLuint program : programs) {
+        glUseProgram(program);
+        glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(camera.getView()));
+        glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(camera.getProjection()));
+    }
+    glUseProgram(0);
+    m_uploadedCameraVersion = camera.getVersion();
 }
 
 // Draws all game elements and particle systems.
-void Game::draw(GLuint gameShader, GLuint particleShader, const glm::mat4& view, const glm::mat4& projection) {
+void Game::draw(GLuint gameShader, GLuint particleShader, const Camera& camera) {
+    PROFILE_SCOPE("Game::draw");
+    ALLOC_SCOPE("Game::draw");
+    m_passTimer.beginFrame();
+    uploadCameraMatrices(gameShader, particleShader, camera);
+
     // Draw player basket using the main game shader (only if running)
     if (m_currentState == GameState::RUNNING) {
-        playerBasket->draw(gameShader, view, projection);
+        GpuPassScope pass(m_passTimer, RENDER_PASS_BASKET);
+        playerBasket->draw(gameShader);
     }
 
     // Draw falling orbs using the main game shader (only if running)
-    for (auto& orb : fallingOrbs) {
-        orb->draw(gameShader, view, projection);
+    {
+        GpuPassScope pass(m_passTimer, RENDER_PASS_ORBS);
+        for (Orb& orb : fallingOrbs) {
+            orb.draw(gameShader);
+        }
     }
 
     // Draw particle systems using the dedicated particle shader
-    for (auto& ps : particleSystems) {
-        ps->draw(particleShader, view, projection);
+    for (int type = 0; type < NUM_ELEMENT_TYPES; ++type) {
+        GpuPassScope pass(m_passTimer, static_cast<RenderPass>(RENDER_PASS_PARTICLES_EARTH + type));
+        particleSystems[type]->draw(particleShader);
+    }
+
+    drawScore(gameShader);
+
+    if (m_currentState != GameState::RUNNING) {
+        GpuPassScope pass(m_passTimer, RENDER_PASS_MESSAGES);
+        drawMessages(gameShader);
     }
+}
 
+// Draws the score in the top right corner, one textured quad per digit.
+void Game::drawScore(GLuint gameShader) {
+    GpuPassScope pass(m_passTimer, RENDER_PASS_HUD);
     m_scoreDigitQuad.setColor(m_lastDestroyedOrbColor); // Apply the last orb's color here!
 
-    std::string scoreStr = std::to_string(std::abs(score)); // Use absolute value for digits
+    char scoreStr[16]; // Formatted on the stack, drawing the HUD doesn't allocate
+    int scoreLength = snprintf(scoreStr, sizeof(scoreStr), "%d", std::abs(score)); // Use absolute value for digits
 
     // Calculate the rightmost X position for the score
     float currentX = (static_cast<float>(screenWidth) / 2.0f) - m_scoreDisplayMarginX;
@@ -989,7 +1111,7 @@ void Game::draw(GLuint gameShader, GLuint particleShader, const glm::mat4& view,
     float startY = (static_cast<float>(screenHeight) / 2.0f) - m_scoreDisplayMarginY - (m_digitHeight / 2.0f);
 
     // Adjust starting X to align the whole number to the right margin
-    float totalScoreWidth = scoreStr.length() * m_digitWidth;
+    float totalScoreWidth = scoreLength * m_digitWidth;
     if (score < 0) {
         totalScoreWidth += m_digitWidth * 0.7f; // Add space for minus sign, roughly 70% of digit width
     }
@@ -1000,14 +1122,15 @@ void Game::draw(GLuint gameShader, GLuint particleShader, const glm::mat4& view,
         m_scoreDigitQuad.textureID = m_minusTexture;
         m_scoreDigitQuad.setPosition(glm::vec3(currentX + (m_digitWidth * 0.35f), startY, 0.0f)); // Position it centered but smaller
         m_scoreDigitQuad.setScale(glm::vec3(m_digitWidth * 0.7f, m_digitHeight, 1.0f)); // Make it smaller/thinner
-        m_scoreDigitQuad.draw(gameShader, view, projection);
+        m_scoreDigitQuad.draw(gameShader);
         currentX += m_digitWidth * 0.7f; // Advance X after drawing minus
     }
 
     // Reset scale for digits after drawing minus sign (if it was drawn)
     m_scoreDigitQuad.setScale(glm::vec3(m_digitWidth, m_digitHeight, 1.0f));
 
-    for (char digitChar : scoreStr) {
+    for (int i = 0; i < scoreLength; ++i) {
+        char digitChar = scoreStr[i];
         int digitValue = digitChar - '0'; // Convert char '0' to int 0, '1' to 1, etc.
         if (digitValue >= 0 && digitValue < 10) {
             // Set the current digit's texture
@@ -1017,58 +1140,93 @@ void Game::draw(GLuint gameShader, GLuint particleShader, const glm::mat4& view,
             m_scoreDigitQuad.setPosition(glm::vec3(currentX + m_digitWidth / 2.0f, startY, 0.0f));
 
             // Draw the digit using the game shader
-            m_scoreDigitQuad.draw(gameShader, view, projection);
+            m_scoreDigitQuad.draw(gameShader);
 
             // Move currentX for the next digit
             currentX += m_digitWidth;
         }
     }
+}
 
-    if (m_currentState != GameState::RUNNING) {
-        m_messageQuad.setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Ensure full color for messages
+// Draws the win/lose message and the restart prompt.
+void Game::drawMessages(GLuint gameShader) {
+    m_messageQuad.setColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // Ensure full color for messages
 
-        // Draw Game Over/Win message
-        m_messageQuad.setScale(glm::vec3(m_messageWidth, m_messageHeight, 1.0f));
-        m_messageQuad.setPosition(glm::vec3(0.0f, 50.0f, 0.0f)); // Slightly above center
-        if (m_currentState == GameState::GAME_OVER_LOSE) {
-            m_messageQuad.textureID = m_gameOverTextureID;
-        }
-        else if (m_currentState == GameState::GAME_OVER_WIN) {
-            m_messageQuad.textureID = m_youWinTextureID;
-        }
-        if (m_messageQuad.textureID != 0) {
-            m_messageQuad.draw(gameShader, view, projection);
-        }
-        else {
-            std::cerr << "Warning: Game Over/Win texture not loaded." << std::endl;
-        }
+    // Draw Game Over/Win message
+    m_messageQuad.setScale(glm::vec3(m_messageWidth, m_messageHeight, 1.0f));
+    m_messageQuad.setPosition(glm::vec3(0.0f, 50.0f, 0.0f)); // Slightly above center
+    if (m_currentState == GameState::GAME_OVER_LOSE) {
+        m_messageQuad.textureID = m_gameOverTextureID;
+    }
+    else if (m_currentState == GameState::GAME_OVER_WIN) {
+        m_messageQuad.textureID = m_youWinTextureID;
+    }
+    if (m_messageQuad.textureID != 0) {
+        m_messageQuad.draw(gameShader);
+    }
+    else {
+        std::cerr << "Warning: Game Over/Win texture not loaded." << std::endl;
+    }
 
-        // Draw "Press R to Restart" message
-        m_messageQuad.setScale(glm::vec3(m_restartMessageWidth, m_restartMessageHeight, 1.0f));
-        m_messageQuad.setPosition(glm::vec3(0.0f, -50.0f, 0.0f)); // Below center
-        m_messageQuad.textureID = m_pressRToRestartTextureID;
-        if (m_messageQuad.textureID != 0) {
-            m_messageQuad.draw(gameShader, view, projection);
-        }
-        else {
-            std::cerr << "Warning: Restart texture not loaded." << std::endl;
-        }
+    // Draw "Press R to Restart" message
+    m_messageQuad.setScale(glm::vec3(m_restartMessageWidth, m_restartMessageHeight, 1.0f));
+    m_messageQuad.setPosition(glm::vec3(0.0f, -50.0f, 0.0f)); // Below center
+    m_messageQuad.textureID = m_pressRToRestartTextureID;
+    if (m_messageQuad.textureID != 0) {
+        m_messageQuad.draw(gameShader);
+    }
+    else {
+        std::cerr << "Warning: Restart texture not loaded." << std::endl;
     }
 }
 
+// Share of a tick a key was held. The first tick has no start, so it counts the key's current state.
+static float heldShare(double heldSeconds, double tickSeconds, bool down) {
+    if (tickSeconds <= 0.0) return down ? 1.0f : 0.0f;
+    return static_cast<float>(heldSeconds / tickSeconds);
+}
+
 // Processes keyboard input for basket movement.
-void Game::processInput(GLFWwindow* window, float deltaTime) {
+// A and D come from the timestamped key events: the basket moves for the share of the tick each key was
+// really held, so a slow frame neither adds nor loses movement and a quick tap between frames still counts.
+InputFrame Game::processInput(GLFWwindow* window, float deltaTime) {
+    double now = glfwGetTime();
+    double tickSeconds = m_lastInputTime >= 0.0 ? now - m_lastInputTime : 0.0;
+    m_lastInputTime = now;
+
+    InputFrame input;
+    input.leftHeld = heldShare(m_leftKey.takeHeldSeconds(now), tickSeconds, m_leftKey.isDown());
+    input.rightHeld = heldShare(m_rightKey.takeHeldSeconds(now), tickSeconds, m_rightKey.isDown());
+    input.restart = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+    input.scroll = m_pendingScroll;
+    m_pendingScroll = 0;
+    applyInput(input, deltaTime);
+    return input;
+}
+
+// Applies one tick of input. Replays call this directly, so it must not read anything but 'input'.
+void Game::applyInput(const InputFrame& input, float deltaTime) {
+    PROFILE_SCOPE("processInput");
+    ALLOC_SCOPE("processInput");
     if (m_currentState == GameState::RUNNING) {
-        // Basket movement (A/D keys)
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-            playerBasket->moveLeft(deltaTime);
+        // Mouse wheel changes the basket type
+        if (input.scroll > 0) {
+            playerBasket->changeType(1); // Scroll up: next type
+        }
+        else if (input.scroll < 0) {
+            playerBasket->changeType(-1); // Scroll down: previous type
+        }
+
+        // Basket movement (A/D keys), for the part of the tick each key was held
+        if (input.leftHeld > 0.0f) {
+            playerBasket->moveLeft(deltaTime * input.leftHeld);
             // Clamp basket to screen bounds (adjust for centered coordinates)
             if (playerBasket->getLeft() < -(static_cast<float>(screenWidth) / 2.0f)) {
                 playerBasket->setPosition(glm::vec3(-(static_cast<float>(screenWidth) / 2.0f) + playerBasket->getScale().x / 2.0f, playerBasket->getPosition().y, 0.0f));
             }
         }
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-            playerBasket->moveRight(deltaTime);
+        if (input.rightHeld > 0.0f) {
+            playerBasket->moveRight(deltaTime * input.rightHeld);
             // Clamp basket to screen bounds (adjust for centered coordinates)
             if (playerBasket->getRight() > (static_cast<float>(screenWidth) / 2.0f)) {
                 playerBasket->setPosition(glm::vec3((static_cast<float>(screenWidth) / 2.0f) - playerBasket->getScale().x / 2.0f, playerBasket->getPosition().y, 0.0f));
@@ -1076,21 +1234,35 @@ void Game::processInput(GLFWwindow* window, float deltaTime) {
         }
     }
     else { // Game is in GAME_OVER state
-        if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+        if (input.restart) {
             resetGame(); // Reset game if 'R' is pressed
         }
     }
 }
 
-// Handles mouse scroll input to change basket type.
+// Queues mouse scroll input; the next processInput applies it, so it is part of the recorded tick.
 void Game::scrollCallback(double yoffset) {
-    if (m_currentState == GameState::RUNNING) { // Only allow type change if game is running
-        if (yoffset > 0) {
-            playerBasket->changeType(1); // Scroll up: next type
-        }
-        else if (yoffset < 0) {
-            playerBasket->changeType(-1); // Scroll down: previous type
-        }
+    if (yoffset > 0) {
+        m_pendingScroll++;
+    }
+    else if (yoffset < 0) {
+        m_pendingScroll--;
+    }
+}
+
+// Called from the GLFW key callback with the time the event was handled. Key repeats carry nothing new.
+void Game::keyCallback(int key, int action, double time) {
+    KeyIntervals* intervals = key == GLFW_KEY_A ? &m_leftKey : key == GLFW_KEY_D ? &m_rightKey : nullptr;
+    if (intervals == nullptr) return;
+    if (action == GLFW_PRESS) intervals->press(time);
+    else if (action == GLFW_RELEASE) intervals->release(time);
+}
+
+void Game::setSeed(uint32_t seed) {
+    m_seed = seed;
+    rng.seed(seed);
+    for (int type = 0; type < NUM_ELEMENT_TYPES; ++type) {
+        particleSystems[type]->seed(seed + 1 + type);
     }
 }
 
@@ -1126,55 +1298,80 @@ void Game::spawnOrb() {
 
     ElementType randomType = static_cast<ElementType>(typeDist(rng));
     float randomX = xDist(rng);
-    float orbSize = 60.0f; // Fixed orb size
+    // Spawn the entire orb just above the screen's top edge. After the window got shorter the newest orb
+    // can still be above that, and then the new one starts level with it to keep fallingOrbs lowest first.
+    float spawnY = static_cast<float>(screenHeight / 2.0f + orbSize / 2.0f);
+    if (!fallingOrbs.empty()) {
+        spawnY = std::max(spawnY, fallingOrbs.back().getPosition().y);
+    }
 
-    auto newOrb = std::make_unique<Orb>(
+    fallingOrbs.emplace_back(
         randomX,
-        static_cast<float>(screenHeight / 2.0f + orbSize / 2.0f), // Spawn the entire orb just above the screen's top edge
+        spawnY,
         orbSize,
         orbSize,
         randomType,
-        orbFallSpeed
+        orbFallSpeed,
+        rng
     );
-    newOrb->init(); // Initialize its mesh and load texture
-    fallingOrbs.push_back(std::move(newOrb));
+    fallingOrbs.back().init(); // Initialize its mesh and load texture
     std::cout << "Orb spawned! Total orbs: " << fallingOrbs.size() << std::endl; // Debug output
 }
 
 // Checks for collisions between falling orbs and the player's basket.
 void Game::checkCollisions() {
+    PROFILE_SCOPE("checkCollisions");
     auto& basket = playerBasket;
 
-    // Iterate through orbs, removing those that collide
-    for (auto it = fallingOrbs.begin(); it != fallingOrbs.end(); ) {
-        Orb* orb = it->get();
+    // fallingOrbs is lowest first, so only a band can reach the basket: skip the few orbs already below
+    // it, then test until the first orb that is entirely above it. Everything after that is higher still.
+    size_t first = 0;
+    while (first < fallingOrbs.size() && fallingOrbs[first].getTop() < basket->getBottom()) {
+        ++first;
+    }
+    size_t last = first;
+    while (last < fallingOrbs.size() && fallingOrbs[last].getBottom() <= basket->getTop()) {
+        ++last;
+    }
+    metricSet(METRIC_COLLISION_BAND_ORBS, static_cast<double>(last - first));
 
-        // Perform AABB collision check
+    // Collect the orbs touching the basket first (most ticks there are none, and then nothing is allocated)
+    FrameVector<size_t> hits{ FrameAllocator<size_t>(frameArena()) };
+    for (size_t i = first; i < last; ++i) {
+        const Orb* orb = &fallingOrbs[i];
         if (checkAABBCollision(
             orb->getLeft(), orb->getBottom(), orb->getScale().x, orb->getScale().y,
             basket->getLeft(), basket->getBottom(), basket->getScale().x, basket->getScale().y
-        )) {
-            // Collision detected!
-            if (orb->getType() == basket->getType()) {
-                score += 5; // Correct catch: increase score
-                m_lastDestroyedOrbColor = getOrbColor(orb->getType()); // Update last destroyed orb color
-                std::cout << "Correct catch! Score: " << score << std::endl;
-                // Emit particles for correct catch
-                particleSystems[orb->getType()]->emit(orb->getPosition(), 50, orb->getType()); // Emit 50 particles
-                ma_sound_start(&m_correctCatchSound); // Play correct sound
-            }
-            else {
-                score -= 2; // Wrong catch: decrease score
-                m_lastDestroyedOrbColor = getOrbColor(orb->getType()); // Update last destroyed orb color
-                std::cout << "Wrong catch! Score: " << score << std::endl;
-                // Emit fewer particles for wrong catch
-                particleSystems[orb->getType()]->emit(orb->getPosition(), 20, orb->getType()); // Fewer particles
-                ma_sound_start(&m_wrongCatchSound); // Play wrong sound
-            }
-            it = fallingOrbs.erase(it); // Remove the orb
-            continue; // Continue to next orb (iterator is already advanced by erase)
+        ) && checkMaskCollision(*orb)) {
+            hits.push_back(i);
         }
-        ++it; // Move to the next orb
+    }
+    if (hits.empty()) return;
+
+    for (size_t index : hits) {
+        const Orb* orb = &fallingOrbs[index];
+        if (orb->getType() == basket->getType()) {
+            score += 5; // Correct catch: increase score
+            m_lastDestroyedOrbColor = getOrbColor(orb->getType()); // Update last destroyed orb color
+            std::cout << "Correct catch! Score: " << score << std::endl;
+            // Emit particles for correct catch
+            particleSystems[orb->getType()]->emit(orb->getPosition(), 50, orb->getType()); // Emit 50 particles
+            m_audio.trigger(SOUND_CORRECT_CATCH); // Play correct sound
+        }
+        else {
+            score -= 2; // Wrong catch: decrease score
+            m_lastDestroyedOrbColor = getOrbColor(orb->getType()); // Update last destroyed orb color
+            std::cout << "Wrong catch! Score: " << score << std::endl;
+            // Emit fewer particles for wrong catch
+            particleSystems[orb->getType()]->emit(orb->getPosition(), 20, orb->getType()); // Fewer particles
+            m_audio.trigger(SOUND_WRONG_CATCH); // Play wrong sound
+        }
+    }
+
+    // Remove the caught orbs, highest first so the other indices stay valid. Each erase only moves the
+    // orbs in front of it, which are the few between the basket and the bottom of the screen.
+    for (auto it = hits.rbegin(); it != hits.rend(); ++it) {
+        fallingOrbs.erase(*it);
     }
 }
 
@@ -1188,27 +1385,31 @@ bool Game::checkAABBCollision(float x1, float y1, float w1, float h1, float x2,
     return collisionX && collisionY;
 }
 
-
-// Base update: Does nothing by default, derived classes will override.
-void GameObject::update(float deltaTime, Game* gameInstance) {}
-
-// Basket update: Movement is input-driven, so no automatic update here.
-void Basket::update(float deltaTime, Game* gameInstance) {
-    // Basket movement is handled by processInput, so this update does nothing.
+// The boxes only say the sprites are close: a catch needs an opaque cell of the orb on an opaque cell
+// of the basket, with both masks placed at their current positions rounded to whole simulation units.
+bool Game::checkMaskCollision(const Orb& orb) {
+    int dx = static_cast<int>(std::floor(orb.getLeft() - playerBasket->getLeft() + 0.5f));
+    int dy = static_cast<int>(std::floor(orb.getBottom() - playerBasket->getBottom() + 0.5f));
+    if (m_basketMask.overlapCount(m_orbMasks[orb.getType()], dx, dy) > 0) {
+        return true;
+    }
+    metricAdd(METRIC_COLLISION_MASK_REJECTS, 1);
+    return false;
 }
 
+
 // Updates the orb's position (makes it fall) and emits particles.
 void Orb::update(float deltaTime, Game* gameInstance) {
     position.y -= fallSpeed * deltaTime;
 
-    position.x = m_initialX + m_zigzagAmplitude * sin(glfwGetTime() * m_zigzagFrequency + m_zigzagPhaseOffset);
+    double time = gameInstance ? gameInstance->getGameTime() : 0.0;
+    position.x = m_initialX + m_zigzagAmplitude * sin(time * m_zigzagFrequency + m_zigzagPhaseOffset);
 
     // Particle emission logic
     m_particleEmitTimer += deltaTime;
     if (m_particleEmitTimer >= m_particleEmitInterval) {
         if (gameInstance) { // Ensure gameInstance is not null
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            std::mt19937& gen = gameInstance->getRng();
             std::uniform_real_distribution<float> xDist(-width / 2.0f, width / 2.0f);
             std::uniform_real_distribution<float> yDist(-height / 2.0f, height / 2.0f);
 
@@ -1235,25 +1436,73 @@ glm::vec3 cameraUp2D = glm::vec3(0.0f, 1.0f, 0.0f); // Y-axis is up
 
 Camera camera(cameraPos2D, cameraDir2D, cameraUp2D); // Camera instance
 
-float deltaTime = 0.0f; // Time between current and last frame
-float lastFrame = 0.0f; // Time of last frame
+// Orthographic projection: centered (0,0) with the window's width/height in world units
+void updateCameraProjection(int width, int height)
+{
+    camera.setOrthographic(-(float)width / 2.0f, (float)width / 2.0f,
+        -(float)height / 2.0f, (float)height / 2.0f,
+        0.1f, 100.0f);
+}
+
+float deltaTime = 0.0f; // Time the game advances this frame, smoothed by the frame pacer
+FramePacer framePacer;  // Swap interval, frame limiter and delta time smoothing (--swap-interval, --fps, --smooth-frames)
+bool redrawRequested = true; // The window needs repainting even if the game didn't change (exposed, resized, restored)
+
+// Low-power tick intervals. In these states the loop waits for events instead of polling, so a key press
+// still gets an immediate response, and otherwise it only wakes up this often.
+static const double IDLE_TICK_SECONDS = 0.25;       // Game over and nothing moving
+static const double MINIMIZED_TICK_SECONDS = 0.1;   // Not drawn, but the game keeps running
+static const double UNFOCUSED_TICK_SECONDS = 0.05;  // Still visible behind another window
 
 std::unique_ptr<Game> game; // Game instance
+std::unique_ptr<PerfOverlay> perfOverlay; // Performance overlay, toggled with F3
+SoakRecorder soakRecorder;   // Once-per-second metrics file for long runs (--soak)
+MetricsServer metricsServer; // Prometheus endpoint on localhost (--metrics-port)
 GLuint gameShaderProgram;    // Shader program for game objects (basket, orbs)
 GLuint particleShaderProgram; // Shader program for particle effects
 
 // GLFW callback for window resize events
 void window_callback(GLFWwindow* window, int new_width, int new_height)
 {
+    if (new_width == 0 || new_height == 0) return; // Minimized: keep the last size, the game keeps running off screen
+
     glViewport(0, 0, new_width, new_height); // Update OpenGL viewport
     current_width = new_width;   // Update global width
     current_height = new_height; // Update global height
+    updateCameraProjection(new_width, new_height); // Only place the projection changes
     std::cout << "Window resized to: " << current_width << "x" << current_height << std::endl;
 
     // Inform the game instance about the new screen dimensions for internal logic adjustments
     if (game) {
         game->setScreenDimensions(new_width, new_height);
     }
+    redrawRequested = true;
+}
+
+// GLFW callback for when the window contents were damaged and have to be drawn again
+void window_refresh_callback(GLFWwindow* window)
+{
+    redrawRequested = true;
+}
+
+// GLFW callback for keys: movement keys go to the game with a timestamp, the rest are debug keys
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (game) {
+        game->keyCallback(key, action, glfwGetTime());
+    }
+    if (action != GLFW_PRESS) return;
+
+    if (key == GLFW_KEY_F3 && perfOverlay) {
+        perfOverlay->toggle();
+    }
+    if (key == GLFW_KEY_F4) {
+        std::cout << "Memory by subsystem:" << std::endl;
+        printMemoryReport(std::cout);
+    }
+    if (key == GLFW_KEY_F9) {
+        profilerExportChromeTrace("trace.json", 300); // Last ~5 seconds at 60 FPS
+    }
 }
 
 // GLFW callback for mouse scroll events
@@ -1264,11 +1513,359 @@ void mouse_scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     }
 }
 
+#ifdef BENCHMARK
+// Microbenchmarks of the core components (built by Lab7Benchmark.vcxproj, which defines BENCHMARK).
+// They run against a hidden window, so texture, shader and draw cases have a real context without showing anything.
+//   --out <file>      JSON output (default benchmark.json)
+//   --filter <text>   Only run cases whose name contains text
+//   --label <text>    Stored in the JSON, e.g. the commit being measured
+// With --replay the recorded sessions are replayed instead (see runReplays below).
+class GameBenchmarks {
+public:
+    static void textures(BenchmarkRunner& runner) {
+        static const char* paths[] = {
+            "textures/basket.png", "textures/earth_orb.png", "textures/water_orb.png", "textures/fire_orb.png",
+            "textures/air_orb.png", "textures/earth_particle.png", "textures/water_particle.png",
+            "textures/fire_particle.png", "textures/air_particle.png", "textures/you_lose.png",
+            "textures/you_win.png", "textures/press_r_to_restart.png", "textures/digits/0.png", "textures/digits/minus.png"
+        };
+        for (const char* path : paths) {
+            GLuint texture = 0;
+            runner.run(std::string("loadTextureUtility/") + path, 20, 1,
+                [&]() { texture = loadTextureUtility(path); },
+                nullptr,
+                [&]() { deleteTextureUtility(texture); glFinish(); });
+        }
+    }
+
+    static void shaders(BenchmarkRunner& runner) {
+        static const char* programs[][2] = {
+            { "SimpleVertexShader.vertexshader", "SimpleFragmentShader.fragmentshader" },
+            { "ParticleVertexShader.vertexshader", "ParticleFragmentShader.fragmentshader" },
+            { "LightVertexShader.vertexshader", "LightFragmentShader.fragmentshader" },
+            { "OverlayVertexShader.vertexshader", "OverlayFragmentShader.fragmentshader" },
+        };
+        for (auto& program : programs) {
+            GLuint id = 0;
+            runner.run(std::string("LoadShaders/") + program[0], 10, 1,
+                [&]() { id = LoadShaders(program[0], program[1]); },
+                nullptr,
+                [&]() { glDeleteProgram(id); glFinish(); });
+        }
+    }
+
+    static void orbInit(BenchmarkRunner& runner) {
+        std::unique_ptr<Orb> orb;
+        std::mt19937 rng(1234);
+        runner.run("Orb::init", 50, 1,
+            [&]() { orb->init(); },
+            [&]() { orb = std::make_unique<Orb>(0.0f, 0.0f, 60.0f, 60.0f, FIRE, 100.0f, rng); },
+            [&]() { orb.reset(); });
+    }
+
+    // Orbs are spread over the top half of the screen, away from the basket, so nothing is removed
+    // and every sample tests the same set. They are added lowest first like spawned orbs, so this
+    // measures the band scan: the cost should stay flat as the orb count grows.
+    static void collisions(BenchmarkRunner& runner, Game& game) {
+        const int counts[] = { 10, 1000, 100000 };
+        const int repeats[] = { 10000, 100, 1 };
+        std::mt19937 rng(1234); // Fixed seed, same layout on every run
+        std::uniform_real_distribution<float> xDist(-game.screenWidth / 2.0f, game.screenWidth / 2.0f);
+        std::uniform_real_distribution<float> yDist(0.0f, game.screenHeight / 2.0f);
+
+        for (int i = 0; i < 3; ++i) {
+            game.fallingOrbs.clear();
+            std::vector<float> heights(counts[i]);
+            for (float& y : heights) y = yDist(rng);
+            std::sort(heights.begin(), heights.end());
+            for (int n = 0; n < counts[i]; ++n) {
+                // No init(): collision only needs the position and scale, not a mesh or texture
+                game.fallingOrbs.emplace_back(xDist(rng), heights[n], 60.0f, 60.0f,
+                    static_cast<ElementType>(n % NUM_ELEMENT_TYPES), 100.0f, rng);
+            }
+            runner.run("checkCollisions/" + std::to_string(counts[i]), 30, repeats[i],
+                [&]() { game.checkCollisions(); },
+                [&]() { frameArena().reset(); });
+        }
+        game.fallingOrbs.clear();
+    }
+
+    // CPU cost of submitting one frame: 20 orbs and a burst of particles in every system
+    static void draw(BenchmarkRunner& runner, Game& game, GLuint gameShader, GLuint particleShader) {
+        game.fallingOrbs.clear();
+        for (int n = 0; n < 20; ++n) {
+            game.fallingOrbs.emplace_back(-400.0f + n * 40.0f, 200.0f, 60.0f, 60.0f,
+                static_cast<ElementType>(n % NUM_ELEMENT_TYPES), 100.0f, game.rng);
+            game.fallingOrbs.back().init();
+        }
+        for (int type = 0; type < NUM_ELEMENT_TYPES; ++type) {
+            game.particleSystems[type]->emit(glm::vec3(0.0f), 200, static_cast<ElementType>(type));
+            game.particleSystems[type]->update(0.0f, glm::vec3(0.0f));
+        }
+
+        runner.run("Game::draw", 100, 1,
+            [&]() { game.draw(gameShader, particleShader, camera); },
+            [&]() { glClear(GL_COLOR_BUFFER_BIT); frameArena().reset(); },
+            [&]() { glFinish(); }); // Wait for the GPU outside the timed part, so samples don't queue up
+        game.fallingOrbs.clear();
+    }
+};
+
+// Replays one session with a fresh Game and measures every tick after the warm-up.
+// Each tick waits for the GPU (glFinish), so frame time includes the GPU work of that tick and nothing else.
+static std::vector<ReplayFrameSample> replaySession(const ReplaySession& session, size_t ticks, size_t warmupTicks) {
+    std::vector<ReplayFrameSample> frames;
+    frames.reserve(ticks); // Reserved up front, so recording samples doesn't show up in the allocation counts
+
+    glfwSetWindowSize(window, session.screenWidth, session.screenHeight);
+    glViewport(0, 0, session.screenWidth, session.screenHeight);
+    updateCameraProjection(session.screenWidth, session.screenHeight);
+    game = std::make_unique<Game>(session.screenWidth, session.screenHeight);
+    game->init();
+    game->setSeed(session.seed);
+
+    glFinish();
+    allocTrackerNextFrame(); // Loading isn't part of any tick
+    glStatsNextFrame();
+    for (size_t i = 0; i < ticks; ++i) {
+        ReplayTick tick = session.getTick(i);
+        frameArena().reset();
+        uint64_t startNs = profilerNow();
+        game->applyInput(tick.input, tick.deltaTime);
+        game->update(tick.deltaTime, camera.getPosition());
+        uint64_t updateEndNs = profilerNow();
+        glClear(GL_COLOR_BUFFER_BIT);
+        game->draw(gameShaderProgram, particleShaderProgram, camera);
+        uint64_t drawEndNs = profilerNow();
+        glFinish();
+        uint64_t endNs = profilerNow();
+        allocTrackerNextFrame();
+        glStatsNextFrame();
+
+        if (i < warmupTicks) continue;
+        ReplayFrameSample sample;
+        sample.updateMs = (updateEndNs - startNs) / 1000000.0f;
+        sample.drawMs = (drawEndNs - updateEndNs) / 1000000.0f;
+        sample.frameMs = (endNs - startNs) / 1000000.0f;
+        sample.drawCalls = static_cast<float>(metricGet(METRIC_DRAW_CALLS));
+        sample.vertices = static_cast<float>(metricGet(METRIC_DRAW_VERTICES));
+        sample.stateChanges = static_cast<float>(metricGet(METRIC_GL_STATE_CHANGES));
+        sample.uploadBytes = static_cast<float>(metricGet(METRIC_GL_UPLOAD_BYTES));
+        sample.allocs = static_cast<float>(metricGet(METRIC_FRAME_ALLOCS));
+        sample.liveParticles = static_cast<float>(metricGet(METRIC_LIVE_PARTICLES_EARTH) + metricGet(METRIC_LIVE_PARTICLES_WATER)
+            + metricGet(METRIC_LIVE_PARTICLES_FIRE) + metricGet(METRIC_LIVE_PARTICLES_AIR));
+        frames.push_back(sample);
+    }
+    game.reset();
+    return frames;
+}
+
+// Frame-time regression gate: replays every session 'runs' times, writes the statistics to outPath
+// and, with a baseline, prints the comparison and fails on a regression.
+//   --replay <file>      Session recorded by the game with --record (repeat for more sessions)
+//   --ticks <n>          Ticks per run (default: the session's length)
+//   --warmup <n>         Ticks not measured at the start of each run (default 60)
+//   --runs <n>           Runs per session (default 5)
+//   --baseline <file>    Results of an earlier run to compare against
+//   --tolerance <x>      Allowed slowdown of timing statistics (default 0.10 = 10%)
+static int runReplays(const std::vector<const char*>& sessionPaths, size_t ticks, size_t warmupTicks, int runs,
+    const char* baselinePath, double tolerance, const char* outPath, const std::string& label) {
+    ReplayHarness harness(tolerance);
+    for (const char* path : sessionPaths) {
+        ReplaySession session;
+        if (!session.load(path)) return 1;
+        size_t sessionTicks = ticks != 0 ? ticks : session.ticks.size();
+        std::string name = path;
+        name = name.substr(name.find_last_of("/\\") + 1); // Sessions are matched to the baseline by file name
+        if (sessionTicks <= warmupTicks) {
+            std::cerr << "Replaying " << name << " would measure nothing: " << sessionTicks << " ticks, "
+                << warmupTicks << " of them warm-up. Use a longer session, more --ticks or less --warmup." << std::endl;
+            return 1;
+        }
+
+        for (int run = 0; run < runs; ++run) {
+            std::cout << "Replaying " << name << " (" << sessionTicks << " ticks), run " << run + 1 << " of " << runs << std::endl;
+            if (!harness.addRun(name, replaySession(session, sessionTicks, warmupTicks))) return 1;
+        }
+    }
+
+    bool passed = harness.writeResults(outPath, label);
+    if (baselinePath != nullptr) {
+        passed = harness.compare(baselinePath, std::cout) && passed;
+    }
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    const char* outPath = nullptr;
+    std::string filter;
+    std::string label;
+    std::vector<const char*> replayPaths;
+    size_t replayTicks = 0;
+    size_t replayWarmup = 60;
+    int replayRuns = 5;
+    const char* baselinePath = nullptr;
+    double tolerance = 0.10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPaths.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) replayTicks = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) replayWarmup = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) replayRuns = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+    }
+
+    if (!glfwInit()) {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return -1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); // Offscreen: the default framebuffer still exists, it is just never shown
+    window = glfwCreateWindow(current_width, current_height, "Element Basket benchmark", NULL, NULL);
+    if (window == NULL) {
+        fprintf(stderr, "Failed to open GLFW window.");
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glewExperimental = true;
+    if (glewInit() != GLEW_OK) {
+        fprintf(stderr, "Failed to initialize GLEW\n");
+        glfwTerminate();
+        return -1;
+    }
+    glDebugInit(false); // Labels and pass groups, for captures of benchmark runs
+    glViewport(0, 0, current_width, current_height);
+    updateCameraProjection(current_width, current_height);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (!meshRegistry().init()) {
+        glfwTerminate();
+        return -1;
+    }
+
+    if (!replayPaths.empty()) {
+        gameShaderProgram = LoadShaders("SimpleVertexShader.vertexshader", "SimpleFragmentShader.fragmentshader");
+        particleShaderProgram = LoadShaders("ParticleVertexShader.vertexshader", "ParticleFragmentShader.fragmentshader");
+        int result = runReplays(replayPaths, replayTicks, replayWarmup, replayRuns, baselinePath, tolerance,
+            outPath != nullptr ? outPath : "replay.json", label);
+        glDeleteProgram(gameShaderProgram);
+        glDeleteProgram(particleShaderProgram);
+        meshRegistry().release();
+        glfwTerminate();
+        return result;
+    }
+
+    BenchmarkRunner runner(filter);
+    GameBenchmarks::textures(runner);
+    GameBenchmarks::shaders(runner);
+    GameBenchmarks::orbInit(runner);
+
+    gameShaderProgram = LoadShaders("SimpleVertexShader.vertexshader", "SimpleFragmentShader.fragmentshader");
+    particleShaderProgram = LoadShaders("ParticleVertexShader.vertexshader", "ParticleFragmentShader.fragmentshader");
+    game = std::make_unique<Game>(current_width, current_height);
+    game->init();
+    GameBenchmarks::collisions(runner, *game);
+    GameBenchmarks::draw(runner, *game, gameShaderProgram, particleShaderProgram);
+    game.reset();
+    glDeleteProgram(gameShaderProgram);
+    glDeleteProgram(particleShaderProgram);
+    meshRegistry().release();
+
+    glfwTerminate();
+    return runner.writeJson(outPath != nullptr ? outPath : "benchmark.json", label) ? 0 : 1;
+}
+#else
+
 // Main function: Entry point of the application
-int main(void)
+// Optional arguments:
+//   --audio-wav <file>   Render audio offline (no sound device) into a WAV file, in lockstep with the game
+//   --alloc-check        Fail (exit code 1) if any frame after warm-up allocates; needs a TRACK_ALLOCATIONS build
+//   --max-draw-calls <n> Fail (exit code 1) if any frame after warm-up issues more than n draw calls
+//   --max-upload-bytes <n> Same for bytes of buffer data uploaded per frame
+//   --soak <file>        Record metrics once per second to a rotating CSV (or JSON Lines if the file ends in .json)
+//   --metrics-port <n>   Serve the metrics in Prometheus format on http://127.0.0.1:<n>/metrics
+//   --seed <n>           Seed for everything random in the game (default: a random seed)
+//   --record <file>      Record the session (seed and input of every tick), for the benchmark's --replay
+//   --gl-debug           Debug context; driver performance warnings and errors go to the log with frame and pass
+//   --swap-interval <n>  Screen refreshes per buffer swap: 1 = vsync (default), 0 = off, -1 = adaptive where supported
+//   --fps <n>            Hold the frame rate to n with the frame limiter, for drivers that force vsync off (default: off)
+//   --smooth-frames <n>  Frames the delta time is averaged over, 1 = no smoothing (default: 4)
+//   --no-low-power       Run at full rate when idle, unfocused or minimized (low-power ticks are the default)
+//   --no-frame-skip      Draw every frame, even when it would look exactly like the one on screen
+int main(int argc, char** argv)
 {
     std::cout << "Starting main function..." << std::endl;
 
+    const char* audioWavPath = nullptr;
+    unsigned int maxDrawCalls = 0;  // 0 = no budget
+    uint64_t maxUploadBytes = 0;
+    const char* recordPath = nullptr;
+    bool glDebugMessages = false;
+    int swapInterval = 1;
+    double targetFps = 0.0;         // 0 = no frame limiter
+    int smoothingFrames = 4;
+    bool lowPowerAllowed = true;
+    bool frameSkipAllowed = true;
+    bool hasSeed = false;
+    uint32_t seed = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--audio-wav") == 0 && i + 1 < argc) {
+            audioWavPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+            soakRecorder.open(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--gl-debug") == 0) {
+            glDebugMessages = true;
+        }
+        else if (strcmp(argv[i], "--swap-interval") == 0 && i + 1 < argc) {
+            swapInterval = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            targetFps = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--smooth-frames") == 0 && i + 1 < argc) {
+            smoothingFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--no-low-power") == 0) {
+            lowPowerAllowed = false;
+        }
+        else if (strcmp(argv[i], "--no-frame-skip") == 0) {
+            frameSkipAllowed = false;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            hasSeed = true;
+        }
+        else if (strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc) {
+            metricsServer.start(static_cast<unsigned short>(strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (strcmp(argv[i], "--max-draw-calls") == 0 && i + 1 < argc) {
+            maxDrawCalls = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--max-upload-bytes") == 0 && i + 1 < argc) {
+            maxUploadBytes = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--alloc-check") == 0) {
+            if (allocTrackerCompiledIn()) {
+                allocTrackerSetSteadyStateCheck(true);
+            }
+            else {
+                std::cerr << "--alloc-check needs a build with TRACK_ALLOCATIONS defined, ignoring it." << std::endl;
+            }
+        }
+    }
+
     // Initialize GLFW
     if (!glfwInit())
     {
@@ -1281,6 +1878,9 @@ int main(void)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (glDebugMessages) {
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE); // Drivers only report most performance warnings in debug contexts
+    }
 
     // Create GLFW window and OpenGL context
     window = glfwCreateWindow(current_width, current_height, "Element Basket", NULL, NULL);
@@ -1295,6 +1895,18 @@ int main(void)
     glfwMakeContextCurrent(window); // Make the window's context current on the calling thread
     std::cout << "OpenGL context made current." << std::endl;
 
+    // Adaptive vsync (negative intervals) tears instead of waiting a whole extra refresh when a frame is late
+    if (swapInterval < 0 && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cerr << "Adaptive vsync is not supported, using swap interval " << -swapInterval << " instead." << std::endl;
+        swapInterval = -swapInterval;
+    }
+    glfwSwapInterval(swapInterval);
+    const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    int refreshHz = videoMode != NULL ? videoMode->refreshRate : 0;
+    framePacer.configure(targetFps, refreshHz, swapInterval, smoothingFrames);
+    std::cout << "Swap interval " << swapInterval << " at " << refreshHz << " Hz, frame limiter "
+        << (targetFps > 0.0 ? std::to_string(targetFps) + " FPS" : std::string("off")) << "." << std::endl;
+
     // Initialize GLEW (OpenGL Extension Wrangler Library)
     glewExperimental = true; // Needed for core profile
     if (glewInit() != GLEW_OK)
@@ -1304,8 +1916,10 @@ int main(void)
         return -1;
     }
     std::cout << "GLEW initialized." << std::endl;
+    glDebugInit(glDebugMessages);
 
     glViewport(0, 0, current_width, current_height); // Set initial OpenGL viewport
+    updateCameraProjection(current_width, current_height);
     std::cout << "Viewport set." << std::endl;
 
     glClearColor(0.2f, 0.3f, 0.5f, 1.0f); // Set background clear color
@@ -1332,53 +1946,159 @@ int main(void)
         return -1;
     }
     std::cout << "Particle shaders loaded." << std::endl;
+    glDebugLabel(GL_PROGRAM, gameShaderProgram, "game shader (SimpleVertexShader + SimpleFragmentShader)");
+    glDebugLabel(GL_PROGRAM, particleShaderProgram, "particle shader (ParticleVertexShader + ParticleFragmentShader)");
+    memoryAdd(MEMORY_SHADERS, 0.0, programBytes(gameShaderProgram) + programBytes(particleShaderProgram));
+
+    // Shared meshes, before anything that draws them is initialized
+    if (!meshRegistry().init()) {
+        std::cerr << "Failed to create meshes! Exiting." << std::endl;
+        glDeleteProgram(gameShaderProgram);
+        glDeleteProgram(particleShaderProgram);
+        glfwTerminate();
+        return -1;
+    }
 
     // Create and initialize the Game instance
-    game = std::make_unique<Game>(current_width, current_height);
+    game = std::make_unique<Game>(current_width, current_height, audioWavPath);
     std::cout << "Game object created." << std::endl;
     game->init(); // This calls init() on all game objects and particle systems
-    std::cout << "Game initialized." << std::endl;
+    if (hasSeed) game->setSeed(seed);
+    std::cout << "Game initialized (seed " << game->getSeed() << ")." << std::endl;
+
+    ReplaySession recording;
+    recording.seed = game->getSeed();
+    recording.screenWidth = current_width;
+    recording.screenHeight = current_height;
 
     // Set GLFW callbacks
     glfwSetFramebufferSizeCallback(window, window_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     glfwSetScrollCallback(window, mouse_scroll_callback);
+    glStatsSetBudget(maxDrawCalls, maxUploadBytes);
+    perfOverlay = std::make_unique<PerfOverlay>();
+    perfOverlay->init();
+
+    glfwSetKeyCallback(window, key_callback); // F3 toggles the performance overlay, F4 prints the memory report, F9 writes a CPU profile of the last frames to trace.json
     std::cout << "Callbacks set. Entering game loop." << std::endl;
 
+    uint64_t shownSignature = 0; // renderSignature of the frame on screen
+
     // Main game loop
     while (!glfwWindowShouldClose(window) && glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS)
     {
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        game->processInput(window, deltaTime);
-        game->update(deltaTime, camera.position); // Pass camera position for particle updates
+        profilerNextFrame();
+        allocTrackerNextFrame();
+        glStatsNextFrame();
+        frameArena().reset(); // Last frame's scratch memory is free again
+        PROFILE_SCOPE("frame");
+
+        deltaTime = framePacer.beginFrame();
+        float frameMs = framePacer.rawFrameMs(); // Diagnostics see the measured time, not the smoothed one
+        metricAdd(METRIC_FRAMES, 1);
+        metricSet(METRIC_FRAME_MS, frameMs);
+        metricObserveFrameTime(frameMs);
+        perfOverlay->recordFrame(frameMs);
+
+        InputFrame input = game->processInput(window, deltaTime);
+        if (recordPath != nullptr) {
+            ALLOC_SCOPE_EXEMPT("recordReplay"); // The tick list grows for the whole session
+            recording.addTick(deltaTime, input);
+        }
+        uint64_t updateStartNs = profilerNow();
+        game->update(deltaTime, camera.getPosition()); // Pass camera position for particle updates
+        float updateMs = (profilerNow() - updateStartNs) / 1000000.0f;
+        metricSet(METRIC_CPU_UPDATE_MS, updateMs);
+        soakRecorder.recordFrame(frameMs, updateMs);
+
+        // A frame that would look exactly like the one on screen isn't drawn or swapped at all.
+        // The overlay's numbers change every frame, so nothing is skipped while it is shown.
+        bool minimized = glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0;
+        bool overlayVisible = perfOverlay->isVisible();
+        unsigned int cameraVersion = camera.getVersion();
+        uint64_t signature = game->renderSignature();
+        signature = hashBytes(signature, &cameraVersion, sizeof(cameraVersion));
+        signature = hashBytes(signature, &overlayVisible, sizeof(overlayVisible));
+        bool unchanged = frameSkipAllowed && !redrawRequested && !overlayVisible && signature == shownSignature;
+        if (minimized || unchanged) { // Nothing to see or nothing new, so nothing to draw or swap
+            if (minimized) redrawRequested = true; // Whatever was on screen is gone when the window comes back
+            else metricAdd(METRIC_FRAMES_SKIPPED, 1);
+            framePacer.skipFrame();
+        }
+        else {
+            glClear(GL_COLOR_BUFFER_BIT); // Clear the screen
 
-        glClear(GL_COLOR_BUFFER_BIT); // Clear the screen
+            // Draw all game elements (the camera's cached matrices are only re-uploaded when they changed)
+            uint64_t drawStartNs = profilerNow();
+            game->draw(gameShaderProgram, particleShaderProgram, camera);
+            metricSet(METRIC_CPU_DRAW_MS, (profilerNow() - drawStartNs) / 1000000.0);
 
-        // Calculate view and projection matrices
-        glm::mat4 view = glm::lookAt(camera.position, camera.position + camera.viewDirection, camera.up);
-        // Orthographic projection: centered (0,0) with dynamic width/height
-        glm::mat4 projection = glm::ortho(-(float)current_width / 2.0f, (float)current_width / 2.0f,
-            -(float)current_height / 2.0f, (float)current_height / 2.0f,
-            0.1f, 100.0f);
+            perfOverlay->draw(current_width, current_height); // On top of everything, does nothing while hidden
 
-        // Draw all game elements
-        game->draw(gameShaderProgram, particleShaderProgram, view, projection);
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(window); // Swap front and back buffers
+            shownSignature = signature;
+            redrawRequested = false;
+        }
 
-        glfwSwapBuffers(window); // Swap front and back buffers
-        glfwPollEvents();        // Process pending events (input, window resize, etc.)
+        // Pick the next tick's rate: full speed while playing in front, a slow tick otherwise
+        double lowPowerTick = 0.0;
+        if (lowPowerAllowed) {
+            if (game->isIdle())                                        lowPowerTick = IDLE_TICK_SECONDS;
+            else if (minimized)                                        lowPowerTick = MINIMIZED_TICK_SECONDS;
+            else if (glfwGetWindowAttrib(window, GLFW_FOCUSED) == 0)   lowPowerTick = UNFOCUSED_TICK_SECONDS;
+        }
+        framePacer.setLowPower(lowPowerTick > 0.0);
+        if (lowPowerTick > 0.0) {
+            PROFILE_SCOPE("glfwWaitEventsTimeout");
+            metricAdd(METRIC_LOW_POWER_FRAMES, 1);
+            glfwWaitEventsTimeout(lowPowerTick); // Sleeps in the OS until input arrives or the tick is due
+        }
+        else {
+            framePacer.waitForDeadline(glfwPollEvents); // Polls while it sleeps, so key events get timestamps close to when they happened
+            glfwPollEvents();        // Process pending events (input, window resize, etc.)
+        }
     }
 
     // Cleanup resources before exiting
     std::cout << "Exiting game loop. Cleaning up." << std::endl;
+    metricsServer.stop();
+    if (recordPath != nullptr) {
+        recording.save(recordPath);
+    }
+    std::cout << "Performance metrics:" << std::endl;
+    printMetrics(std::cout);
+    if (allocTrackerCompiledIn()) {
+        std::cout << "Heap allocations:" << std::endl;
+        allocTrackerReport(std::cout);
+    }
+    std::cout << "GL commands in the last frame:" << std::endl;
+    glStatsPrintLastFrame(std::cout);
+    std::cout << "Memory by subsystem:" << std::endl;
+    printMemoryReport(std::cout);
     glDeleteProgram(gameShaderProgram);
     glDeleteProgram(particleShaderProgram);
     game.reset(); // Destroy game object and its components
+    perfOverlay.reset();
+    meshRegistry().release(); // After the game, nothing draws the meshes any more
 
     glfwTerminate(); // Terminate GLFW
 
+    bool checksFailed = false;
+    if (glStatsBudgetFailed()) {
+        std::cerr << "GL budget check FAILED: frames went over the draw call or upload budget (see the log above)." << std::endl;
+        checksFailed = true;
+    }
+    if (allocTrackerCheckFailed()) {
+        std::cerr << "Allocation check FAILED: steady-state frames allocated (see the log above)." << std::endl;
+        checksFailed = true;
+    }
+    if (checksFailed) {
+        return 1;
+    }
+
     std::cout << "Program exited successfully." << std::endl;
     return 0;
 }
+#endif // BENCHMARK
 